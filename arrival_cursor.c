@@ -0,0 +1,180 @@
+//
+// Arrival Cursor
+// Implementation File
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "include/arrival_cursor.h"
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// Unsigned sort keys; flipping the sign bit keeps negative values ordered
+// before positive ones
+static uint64_t pid_key(const Job *job) {
+    return (uint32_t)job->PID ^ 0x80000000u;
+}
+
+static uint64_t arrival_key(const Job *job) {
+    return (uint64_t)job->arrival ^ 0x8000000000000000ull;
+}
+
+static int entry_before(const Job *a, const Job *b) {
+    if (a->arrival != b->arrival) {
+        return a->arrival < b->arrival;
+    }
+    return a->PID < b->PID;
+}
+
+// Stable LSD radix sort of order[0..n) by the low bits of key(job), one byte
+// per pass. Passes where every key has the same byte are skipped, so small
+// values cost only a few passes. keys has room for 2n entries, scratch for n.
+static void radix_sort(Job **jobs, int n, int *order, uint64_t (*key)(const Job *job), int bits,
+                       uint64_t *keys, int *scratch) {
+    uint64_t *key_scratch = keys + n;
+    for (int i = 0; i < n; i++) {
+        keys[i] = key(jobs[order[i]]);
+    }
+
+    int *src = order, *dst = scratch;
+    uint64_t *src_keys = keys, *dst_keys = key_scratch;
+    for (int shift = 0; shift < bits; shift += RADIX_BITS) {
+        int counts[RADIX_BUCKETS] = { 0 };
+        for (int i = 0; i < n; i++) {
+            counts[(src_keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        if (counts[(src_keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n) {
+            continue;
+        }
+
+        int start = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            int c = counts[b];
+            counts[b] = start;
+            start += c;
+        }
+        for (int i = 0; i < n; i++) {
+            int slot = counts[(src_keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            dst[slot] = src[i];
+            dst_keys[slot] = src_keys[i];
+        }
+
+        int *t = src; src = dst; dst = t;
+        uint64_t *tk = src_keys; src_keys = dst_keys; dst_keys = tk;
+    }
+
+    if (src != order) {
+        for (int i = 0; i < n; i++) {
+            order[i] = src[i];
+        }
+    }
+}
+
+// By PID first, then (stably) by arrival, so ties in arrival stay in PID order
+int sort_by_arrival(Job **jobs, int n, int *order) {
+    if (n <= 0) {
+        return 0;
+    }
+
+    uint64_t *keys = (uint64_t*)malloc(sizeof(uint64_t) * n * 2);
+    int *scratch = (int*)malloc(sizeof(int) * n);
+    if (keys == NULL || scratch == NULL) {
+        free(keys);
+        free(scratch);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    radix_sort(jobs, n, order, pid_key, 32, keys, scratch);
+    radix_sort(jobs, n, order, arrival_key, 64, keys, scratch);
+
+    free(keys);
+    free(scratch);
+    return 0;
+}
+
+ArrivalCursor* create_arrival_cursor(Job **jobs, int n, int capacity) {
+    if (n < 0 || capacity < n) {
+        return NULL;
+    }
+
+    ArrivalCursor *cursor = (ArrivalCursor*)malloc(sizeof(ArrivalCursor));
+    if (cursor == NULL) {
+        return NULL;
+    }
+
+    int room = (capacity > 0) ? capacity : 1;
+    cursor->jobs = (Job**)malloc(sizeof(Job*) * room);
+    cursor->order = (int*)malloc(sizeof(int) * room);
+    if (cursor->jobs == NULL || cursor->order == NULL || sort_by_arrival(jobs, n, cursor->order) != 0) {
+        destroy_arrival_cursor(cursor);
+        return NULL;
+    }
+
+    for (int i = 0; i < n; i++) {
+        cursor->jobs[i] = jobs[i];
+    }
+    cursor->count = n;
+    cursor->capacity = capacity;
+    cursor->next = 0;
+    return cursor;
+}
+
+void destroy_arrival_cursor(ArrivalCursor *cursor) {
+    if (cursor == NULL) {
+        return;
+    }
+    free(cursor->jobs);
+    free(cursor->order);
+    free(cursor);
+}
+
+// Submitted jobs arrive one at a time, so an insertion step keeps the
+// entries not handed out yet sorted
+int arrival_cursor_insert(ArrivalCursor *cursor, Job *job) {
+    if (cursor == NULL || job == NULL || cursor->count >= cursor->capacity) {
+        return -1;
+    }
+
+    int index = cursor->count++;
+    cursor->jobs[index] = job;
+
+    int pos = index;
+    while (pos > cursor->next && entry_before(job, cursor->jobs[cursor->order[pos - 1]])) {
+        cursor->order[pos] = cursor->order[pos - 1];
+        pos--;
+    }
+    cursor->order[pos] = index;
+    return index;
+}
+
+int arrival_cursor_next(ArrivalCursor *cursor, SimTime clock_tick) {
+    if (cursor == NULL || cursor->next >= cursor->count) {
+        return -1;
+    }
+
+    int index = cursor->order[cursor->next];
+    if (cursor->jobs[index]->arrival > clock_tick) {
+        return -1;
+    }
+    cursor->next++;
+    return index;
+}
+
+SimTime arrival_cursor_peek_time(const ArrivalCursor *cursor) {
+    if (cursor == NULL || cursor->next >= cursor->count) {
+        return SIM_TIME_MAX;
+    }
+    return cursor->jobs[cursor->order[cursor->next]]->arrival;
+}
+
+int arrival_cursor_pending(const ArrivalCursor *cursor) {
+    if (cursor == NULL) {
+        return 0;
+    }
+    return cursor->count - cursor->next;
+}
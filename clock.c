@@ -1,15 +1,19 @@
 #include "include/clock.h"
 
-static int clock_time = 0;
+void init_clock(SimContext *sim) {
+    sim->clock = 0;
+}
 
-void init_clock(void) {
-    clock_time = 0;
+SimTime current_clock(const SimContext *sim) {
+    return sim->clock;
 }
 
-int current_clock(void) {
-    return clock_time;
+void next_tick(SimContext *sim) {
+    sim->clock++;
 }
 
-void next_tick(void) {
-    clock_time++;
-}
\ No newline at end of file
+void advance_clock_to(SimContext *sim, SimTime time) {
+    if (time > sim->clock) {
+        sim->clock = time;
+    }
+}
@@ -0,0 +1,104 @@
+//
+// Policy Comparison
+// Implementation File
+//
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include "include/compare.h"
+
+#define NUM_POLICIES 3
+
+static const SchedulerPolicy policies[NUM_POLICIES] = {
+    SCHED_POLICY_SJF, SCHED_POLICY_RR, SCHED_POLICY_MLFQ
+};
+
+typedef struct {
+    Job **jobs;
+    int n;
+    SchedulerConfig config;
+    Global_Info info;
+    int failed;
+} PolicyRun;
+
+static void *policy_worker(void *arg) {
+    PolicyRun *run = (PolicyRun*)arg;
+    run->failed = simulate_summary(run->jobs, run->n, &run->config, 1, &run->info) != 0;
+    return NULL;
+}
+
+static void print_comparison(const PolicyRun *runs) {
+    char rr_name[32];
+    snprintf(rr_name, sizeof(rr_name), "RR (q=%d)", runs[1].config.time_quantum);
+
+    printf("%-34s | %-14s | %-14s | %-14s\n", "Policy", "SJF", rr_name, "MLFQ");
+    const char *labels[7] = {
+        "Total simulation run time", "Total number of jobs",
+        "Shortest job completion time", "Longest job completion time",
+        "Average job completion time", "Average time in ready queue",
+        "Average time sleeping on I/O state"
+    };
+    for (int row = 0; row < 7; row++) {
+        printf("%-34s", labels[row]);
+        for (int p = 0; p < NUM_POLICIES; p++) {
+            const Global_Info *info = &runs[p].info;
+            if (runs[p].failed) {
+                printf(" | %-14s", "failed");
+                continue;
+            }
+            switch (row) {
+                case 0: printf(" | %-14lld", info->total_simulate_time); break;
+                case 1: printf(" | %-14d", info->total_number_of_job); break;
+                case 2: printf(" | %-14lld", info->shortest_job_completion_time); break;
+                case 3: printf(" | %-14lld", info->longest_job_completion_time); break;
+                case 4: printf(" | %-14.2f", info->average_completion); break;
+                case 5: printf(" | %-14.2f", info->average_ready); break;
+                case 6: printf(" | %-14.2f", info->average_sleep); break;
+            }
+        }
+        printf("\n");
+    }
+}
+
+int run_policy_comparison(Job **jobs, int n, const SchedulerConfig *base) {
+    if (jobs == NULL || n <= 0 || base == NULL) {
+        fprintf(stderr, "Error: no jobs available for the comparison\n");
+        return -1;
+    }
+    if (base->time_quantum <= 0) {
+        fprintf(stderr, "Error: round-robin requires a positive time quantum\n");
+        return -1;
+    }
+
+    PolicyRun runs[NUM_POLICIES];
+    pthread_t workers[NUM_POLICIES];
+    int started[NUM_POLICIES];
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        runs[p].jobs = jobs;
+        runs[p].n = n;
+        runs[p].config = *base;
+        runs[p].config.policy = policies[p];
+        // One host thread per run, no streaming
+        runs[p].config.host_threads = 1;
+        runs[p].config.submissions = NULL;
+        runs[p].failed = 0;
+        started[p] = pthread_create(&workers[p], NULL, policy_worker, &runs[p]) == 0;
+    }
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        if (started[p]) {
+            pthread_join(workers[p], NULL);
+        } else {
+            // No thread: run this policy here
+            policy_worker(&runs[p]);
+        }
+    }
+
+    print_comparison(runs);
+
+    int status = 0;
+    for (int p = 0; p < NUM_POLICIES; p++) {
+        if (runs[p].failed) status = -1;
+    }
+    return status;
+}
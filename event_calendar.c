@@ -0,0 +1,117 @@
+//
+// Event Calendar
+// Implementation File
+//
+
+#include <stdlib.h>
+
+#include "include/event_calendar.h"
+
+#define EVENT_CALENDAR_INITIAL_CAPACITY 16
+
+static int event_before(const Event *a, const Event *b) {
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    if (a->type != b->type) {
+        return a->type < b->type;
+    }
+    return a->order < b->order;
+}
+
+EventCalendar* create_event_calendar(int expected) {
+    EventCalendar *calendar = (EventCalendar*)malloc(sizeof(EventCalendar));
+    if (calendar == NULL) {
+        return NULL;
+    }
+
+    int capacity = EVENT_CALENDAR_INITIAL_CAPACITY;
+    while (capacity < expected) {
+        capacity *= 2;
+    }
+    calendar->events = (Event*)malloc(capacity * sizeof(Event));
+    if (calendar->events == NULL) {
+        free(calendar);
+        return NULL;
+    }
+    calendar->size = 0;
+    calendar->capacity = capacity;
+    return calendar;
+}
+
+void destroy_event_calendar(EventCalendar *calendar) {
+    if (calendar == NULL) {
+        return;
+    }
+    free(calendar->events);
+    free(calendar);
+}
+
+int schedule_event(EventCalendar *calendar, Event event) {
+    if (calendar == NULL) {
+        return -1;
+    }
+
+    if (calendar->size == calendar->capacity) {
+        int new_capacity = calendar->capacity * 2;
+        Event *tmp = (Event*)realloc(calendar->events, new_capacity * sizeof(Event));
+        if (tmp == NULL) {
+            return -1;
+        }
+        calendar->events = tmp;
+        calendar->capacity = new_capacity;
+    }
+
+    // Sift up
+    int index = calendar->size++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!event_before(&event, &calendar->events[parent])) {
+            break;
+        }
+        calendar->events[index] = calendar->events[parent];
+        index = parent;
+    }
+    calendar->events[index] = event;
+    return 0;
+}
+
+int next_event(EventCalendar *calendar, Event *out) {
+    if (calendar == NULL || calendar->size == 0) {
+        return 0;
+    }
+
+    *out = calendar->events[0];
+    Event last = calendar->events[--calendar->size];
+
+    // Sift the last event down from the root
+    int index = 0;
+    int half = calendar->size / 2;
+    while (index < half) {
+        int child = 2 * index + 1;
+        if (child + 1 < calendar->size &&
+            event_before(&calendar->events[child + 1], &calendar->events[child])) {
+            child++;
+        }
+        if (!event_before(&calendar->events[child], &last)) {
+            break;
+        }
+        calendar->events[index] = calendar->events[child];
+        index = child;
+    }
+    if (calendar->size > 0) {
+        calendar->events[index] = last;
+    }
+    return 1;
+}
+
+SimTime next_event_time(const EventCalendar *calendar) {
+    if (calendar == NULL || calendar->size == 0) {
+        return -1;
+    }
+    return calendar->events[0].time;
+}
+
+int event_calendar_size(const EventCalendar *calendar) {
+    return calendar == NULL ? 0 : calendar->size;
+}
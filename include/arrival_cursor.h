@@ -0,0 +1,38 @@
+//
+// Arrival Cursor
+// Header File
+//
+
+#ifndef ARRIVAL_CURSOR_H
+#define ARRIVAL_CURSOR_H
+
+#include "job.h"
+
+// Job indices in (arrival, PID) order, handed out front to back as the
+// clock advances. The order is built with a linear-time radix sort, so
+// schedulers neither scan every job per tick nor sort at startup.
+typedef struct {
+    Job **jobs;         // Job of each index (the caller's job i is index i)
+    int *order;         // Indices sorted by (arrival, PID)
+    int count;          // Entries in order
+    int capacity;       // Room for indices added with arrival_cursor_insert()
+    int next;           // First entry not handed out yet
+} ArrivalCursor;
+
+// Sort jobs[0..n) by (arrival, PID); order receives the n indices. Stable.
+// Returns 0 on success, -1 if out of memory.
+int sort_by_arrival(Job **jobs, int n, int *order);
+
+// capacity >= n reserves indices n..capacity-1 for submitted jobs
+ArrivalCursor* create_arrival_cursor(Job **jobs, int n, int capacity);
+void destroy_arrival_cursor(ArrivalCursor *cursor);
+
+// Add job as index cursor->count (returned), placed among the entries not
+// handed out yet; -1 if the cursor is full
+int arrival_cursor_insert(ArrivalCursor *cursor, Job *job);
+
+int arrival_cursor_next(ArrivalCursor *cursor, SimTime clock_tick);   // Next index arrived by clock_tick, or -1
+SimTime arrival_cursor_peek_time(const ArrivalCursor *cursor);        // Arrival of the next entry, SIM_TIME_MAX if none
+int arrival_cursor_pending(const ArrivalCursor *cursor);          // Entries not handed out yet
+
+#endif //ARRIVAL_CURSOR_H
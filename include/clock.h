@@ -1,8 +1,11 @@
 #ifndef CLOCK_H
 #define CLOCK_H
 
-void init_clock(void);
-int current_clock(void);
-void next_tick(void);
+#include "sim_context.h"
+
+void init_clock(SimContext *sim);
+SimTime current_clock(const SimContext *sim);
+void next_tick(SimContext *sim);
+void advance_clock_to(SimContext *sim, SimTime time);  // Jump forward to time (never backwards)
 
 #endif //CLOCK_H
@@ -0,0 +1,18 @@
+//
+// Policy Comparison
+// Header File
+//
+
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include "job.h"
+#include "scheduler.h"
+
+// Runs SJF, RR and MLFQ on base's other settings, each on its own host thread
+// with its own copies of jobs and random seed 1 (so every column matches a
+// separate run of that policy), and prints the three summaries side by side.
+// jobs is only read. Returns 0 if every policy ran.
+int run_policy_comparison(Job **jobs, int n, const SchedulerConfig *base);
+
+#endif //COMPARE_H
@@ -0,0 +1,44 @@
+//
+// Event Calendar
+// Header File
+//
+
+#ifndef EVENT_CALENDAR_H
+#define EVENT_CALENDAR_H
+
+#include "job.h"
+
+// Event kinds. Events due at the same tick are handled in this order, which
+// mirrors the step order of the tick loops.
+typedef enum {
+    EVENT_BURST_END = 0,    // Running job completed, requested I/O or used up its MLFQ slice (end of the previous tick)
+    EVENT_BOOST,            // MLFQ priority boost (top of the tick)
+    EVENT_ARRIVAL,          // Job arrives
+    EVENT_IO_DONE,          // Job finishes I/O
+    EVENT_QUANTUM_EXPIRY    // RR time slice used up (checked after arrivals and I/O)
+} EventType;
+
+typedef struct {
+    SimTime time;               // Tick the event is due
+    EventType type;
+    long order;                 // Tie-break among same-time events of one type (lower first)
+    int target;                 // Job context index (-1 if none)
+    unsigned int generation;    // Target's generation when scheduled; stale events are skipped
+} Event;
+
+// Binary min-heap of events ordered by (time, type, order)
+typedef struct {
+    Event *events;
+    int size;
+    int capacity;
+} EventCalendar;
+
+EventCalendar* create_event_calendar(int expected);
+void destroy_event_calendar(EventCalendar *calendar);
+
+int schedule_event(EventCalendar *calendar, Event event);  // 0 on success, -1 if out of memory
+int next_event(EventCalendar *calendar, Event *out);       // 1 if an event was removed into out, 0 if empty
+SimTime next_event_time(const EventCalendar *calendar);    // -1 if empty
+int event_calendar_size(const EventCalendar *calendar);
+
+#endif //EVENT_CALENDAR_H
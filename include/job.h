@@ -5,23 +5,30 @@
 #ifndef JOB_H
 #define JOB_H
 
+#include <limits.h>
+
+// Simulated ticks (clock, arrival, service and per-job accounting). 64-bit, so
+// traces running for billions of ticks do not overflow.
+typedef long long SimTime;
+#define SIM_TIME_MAX LLONG_MAX
+
 typedef struct {
-    int ready;
-    int sleep;
-    int total;
-    int completion_time;
+    SimTime ready;
+    SimTime sleep;
+    SimTime total;
+    SimTime completion_time;
 } OutputBlock;
 
 typedef struct {
     int PID;
-    int arrival;
-    int service;
+    SimTime arrival;
+    SimTime service;
     int priority;
     OutputBlock info;
 } Job;
 
 void init_OutputBlock(OutputBlock *info);
-void init_Job(Job **job, int pid, int arrival, int service, int priority);
+void init_Job(Job **job, int pid, SimTime arrival, SimTime service, int priority);
 
 OutputBlock get_Job_info(const Job *job);
 
@@ -29,4 +36,8 @@ void wait(Job *job);
 void run(Job *job);
 void sleep(Job *job);
 
+void wait_span(Job *job, SimTime ticks);
+void sleep_span(Job *job, SimTime ticks);
+void run_span(Job *job, SimTime ticks);
+
 #endif //JOB_H
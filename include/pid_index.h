@@ -0,0 +1,33 @@
+//
+// PID Index
+// Open-addressing hash table mapping a PID to a pointer (usually a Job)
+//
+
+#ifndef PID_INDEX_H
+#define PID_INDEX_H
+
+// One table slot; value == NULL marks an empty slot
+typedef struct {
+    int pid;
+    void *value;
+} PidIndexSlot;
+
+// Linear-probing table, kept at most half full
+typedef struct {
+    PidIndexSlot *slots;
+    int capacity;            // Number of slots, always a power of two
+    int shift;               // 32 - log2(capacity): hashes keep their top bits
+    int count;               // Number of stored PIDs
+} PidIndex;
+
+PidIndex* create_pid_index(int expected_count);
+void destroy_pid_index(PidIndex *index);
+void clear_pid_index(PidIndex *index);
+
+// Returns 0 if inserted, 1 if the PID is already present (table unchanged), -1 on allocation failure
+int pid_index_insert(PidIndex *index, int pid, void *value);
+int pid_index_reserve(PidIndex *index, int extra);  // Grow so extra more inserts cannot fail; 0 or -1
+void* pid_index_find(const PidIndex *index, int pid);  // NULL if not present
+void pid_index_remove(PidIndex *index, int pid);
+
+#endif //PID_INDEX_H
@@ -5,28 +5,86 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include <stddef.h>
+
 #include "job.h"
+#include "pid_index.h"
 
 // Queue types
 typedef enum {
     QUEUE_FIFO,              // First-In-First-Out (for Round Robin, I/O queue)
     QUEUE_SJF,               // Shortest Job First (priority by remaining time)
-    QUEUE_PRIORITY           // Priority queue (for MLFQ levels)
+    QUEUE_PRIORITY,          // Priority queue (for MLFQ levels)
+    QUEUE_SJF_HEAP,          // Same ordering as QUEUE_SJF, backed by a binary min-heap
+    QUEUE_PRIORITY_HEAP,     // Same ordering as QUEUE_PRIORITY, backed by a binary min-heap
+    QUEUE_FIFO_RING          // Same ordering as QUEUE_FIFO, backed by a growable ring buffer
 } QueueType;
 
-// Queue Node - wraps a Job pointer with a next pointer
+// Queue Node - wraps a Job pointer with next/prev pointers.
+// Nodes normally come from the queue's pool, but a node can also be embedded
+// in a caller-owned struct (intrusive use, see enqueue_node).
 typedef struct QueueNode {
     Job *job;                    // Pointer to the job
-    int remaining_time;          // Remaining service time (for SJF scheduling)
+    SimTime remaining_time;      // Remaining service time (for SJF scheduling)
     struct QueueNode *next;      // Pointer to next node
+    struct QueueNode *prev;      // Pointer to previous node (list types only)
+    unsigned long seq;           // Insertion order (final tie-break in heap-backed queues)
+    int heap_index;              // Slot in the heap array (heap types only)
+    unsigned char pooled;        // 1 if allocated from the queue's pool, 0 if caller-owned
+    unsigned char linked;        // 1 while the node is in a queue
 } QueueNode;
 
-// Queue structure (implemented as linked list)
+// Recover the struct that embeds a QueueNode member
+#define queue_node_container(node, type, member) \
+    ((type*)((char*)(node) - offsetof(type, member)))
+
+// Block of nodes carved up by a queue's node pool
+typedef struct QueueNodeSlab {
+    struct QueueNodeSlab *next;  // Next slab owned by the same queue
+    QueueNode nodes[];           // Node storage
+} QueueNodeSlab;
+
+// Ring buffer slot (QUEUE_FIFO_RING). Jobs are stored inline so a walk over
+// the queue reads contiguous memory.
+typedef struct {
+    Job *job;                    // Pointer to the job
+    SimTime remaining_time;      // Remaining service time
+    QueueNode *node;             // Node passed to enqueue_node(), NULL for enqueue()
+} QueueRingEntry;
+
+// Operation counters, collected once queue_enable_stats() is called.
+// Steps count the nodes an operation has to pass: sorted-list walk steps,
+// heap sift levels, ring slots shifted and nodes searched to find a job.
+// Depth is sampled after every operation that changes the size.
+typedef struct {
+    unsigned long enqueues;      // Jobs added (including splices and batches)
+    unsigned long dequeues;      // Jobs taken from the front
+    unsigned long removals;      // Jobs taken out of the middle (remove_node/remove_job)
+    unsigned long insert_steps;  // Steps spent placing jobs (inserts and repositions)
+    unsigned long remove_steps;  // Steps spent taking jobs out and locating them
+    int max_depth;               // Largest size seen
+    unsigned long depth_sum;     // Sum of sampled sizes
+    unsigned long depth_samples; // Number of sampled sizes
+} QueueStats;
+
+// Queue structure (implemented as linked list, as a binary heap for *_HEAP
+// types, or as a ring buffer for QUEUE_FIFO_RING)
 typedef struct Queue {
-    QueueNode *head;         // Pointer to first node in queue
-    QueueNode *tail;         // Pointer to last node in queue
+    QueueNode *head;         // Pointer to first node in queue (list types only)
+    QueueNode *tail;         // Pointer to last node in queue (list types only)
     int size;                // Number of jobs in queue
     QueueType type;          // Type of queue (affects insertion order)
+    QueueNode **heap;        // Heap array, heap[0] is the next job (heap types only)
+    int heap_capacity;       // Allocated slots in heap
+    unsigned long next_seq;  // Sequence number given to the next enqueued node
+    QueueNode *free_nodes;   // Pool: released nodes waiting to be reused
+    QueueNodeSlab *slabs;    // Pool: slabs backing every node of this queue
+    QueueRingEntry *ring;    // Ring storage (ring type only)
+    int ring_capacity;       // Slots in ring, always a power of two
+    int ring_head;           // Slot of the first job in ring
+    int ring_tail;           // Slot the next enqueued job goes into
+    PidIndex *pid_index;     // Optional PID -> Job index (see queue_enable_pid_index)
+    QueueStats *stats;       // Optional operation counters (see queue_enable_stats)
 } Queue;
 
 // Function declarations
@@ -34,19 +92,41 @@ typedef struct Queue {
 // Queue management
 Queue* create_queue(QueueType type);
 void destroy_queue(Queue *queue);
-void clear_queue(Queue *queue);  // Remove all jobs but don't destroy them
+void clear_queue(Queue *queue);  // Remove all jobs but don't destroy them (also releases the node pool)
 
 // Queue operations
-void enqueue(Queue *queue, Job *job, int remaining_time);
+int enqueue(Queue *queue, Job *job, SimTime remaining_time, QueueNode **handle);  // 0 or -1; handle may be NULL
 Job* dequeue(Queue *queue);
 Job* peek(Queue *queue);
 int is_empty(Queue *queue);
 int queue_size(Queue *queue);
+void queue_for_each(Queue *queue, void (*visit)(Job *job));  // Visit jobs in queue order (heap order for heaps)
+
+// Intrusive operations: the node is owned by the caller (zero-initialize it
+// once) and is linked in place, so nothing is allocated or freed. Ring queues
+// store the node pointer next to the job and hand it back on dequeue_node().
+int enqueue_node(Queue *queue, QueueNode *node, Job *job, SimTime remaining_time);  // 0 or -1
+QueueNode* dequeue_node(Queue *queue);
+QueueNode* peek_node(Queue *queue);
+
+// Bulk operations
+void enqueue_nodes(Queue *queue, QueueNode **nodes, int count);  // Caller-owned nodes with job/remaining_time set
+void enqueue_batch(Queue *queue, Job **jobs, const SimTime *remaining_times, int count);
+void queue_splice(Queue *dst, Queue *src);  // Move all of src to dst; O(1) for FIFO list->list and ring->empty ring, memcpy for ring->ring
+void sort_nodes_by_pid(QueueNode **nodes, int count);  // In place, never allocates; PIDs must be unique
+
+// Handle-based operations (handle from enqueue() or a node passed to enqueue_node()).
+// enqueue() on a ring queue sets the handle to NULL: ring slots move, so they have no handle.
+void remove_node(Queue *queue, QueueNode *node);  // O(1) for lists, O(log n) for heaps, O(n) for rings
+void reposition_node(Queue *queue, QueueNode *node, SimTime new_remaining_time);  // Decrease/increase-key
 
 // Utility functions
 void remove_job(Queue *queue, Job *job);  // Remove specific job from queue
+int queue_enable_pid_index(Queue *queue);  // Make find_job_by_pid() O(1)
+int queue_enable_stats(Queue *queue);  // Start counting operations (see QueueStats)
+const QueueStats* queue_get_stats(const Queue *queue);  // NULL unless stats are enabled
 Job* find_job_by_pid(Queue *queue, int pid);  // Find job by PID
 void print_queue(Queue *queue);  // For debugging
-void update_remaining_time(Queue *queue, Job *job, int new_remaining_time);  // Update remaining time for a job in queue
+void update_remaining_time(Queue *queue, Job *job, SimTime new_remaining_time);  // Update remaining time and re-sort
 
 #endif //QUEUE_H
@@ -0,0 +1,25 @@
+//
+// Multi-Seed Replications
+// Header File
+//
+
+#ifndef REPLICATE_H
+#define REPLICATE_H
+
+#include "job.h"
+#include "scheduler.h"
+
+// Fewest replications the stopping rule will accept
+#define REPLICATE_MIN_RUNS 5
+#define REPLICATE_MAX_RUNS 100000
+
+// Runs base on jobs with seeds 1, 2, ... (seed 1 is the normal single run),
+// up to max_runs replications on a pool of threads host threads (one per
+// online CPU if threads <= 0), and prints the mean and 95% confidence interval
+// of each summary metric. If ci_width > 0, stops at the first n >=
+// REPLICATE_MIN_RUNS replications whose every interval half-width is within
+// ci_width (a fraction, e.g. 0.01) of its mean; that n does not depend on the
+// thread count. jobs is only read. Returns 0 on success.
+int run_replications(Job **jobs, int n, const SchedulerConfig *base, int max_runs, double ci_width, int threads);
+
+#endif //REPLICATE_H
@@ -6,6 +6,14 @@
 #define SCHEDULER_H
 
 #include "job.h"
+#include "queue.h"
+#include "submission.h"
+#include "sim_context.h"
+
+#define QUEUE_STATS_MAX_QUEUES 8
+
+// MLFQ levels (time slices and boost interval are in SchedulerConfig)
+#define MLFQ_NUM_QUEUES 3
 
 typedef enum {
     SCHED_POLICY_SJF,
@@ -14,23 +22,90 @@ typedef enum {
 } SchedulerPolicy;
 
 typedef struct {
-    int total_simulate_time;
+    SimTime total_simulate_time;
     int total_number_of_job;
-    int shortest_job_completion_time;
-    int longest_job_completion_time;
+    SimTime shortest_job_completion_time;
+    SimTime longest_job_completion_time;
     double average_completion;
     double average_ready;
     double average_sleep;
 } Global_Info;
 
+// How a simulation advances time
+typedef enum {
+    SCHED_ENGINE_TICK,   // One loop pass per tick (reference mode)
+    SCHED_ENGINE_EVENT   // Jump from event to event (see scheduler_event.c)
+} SchedulerEngine;
+
+// Counters of one scheduler queue, copied out before the queue is destroyed
+typedef struct {
+    char name[16];
+    QueueType type;
+    QueueStats stats;
+} QueueStatsEntry;
+
+typedef struct QueueStatsReport {
+    int count;
+    QueueStatsEntry entries[QUEUE_STATS_MAX_QUEUES];
+} QueueStatsReport;
+
+// Counters of one simulated CPU in a multi-CPU run
+typedef struct {
+    SimTime busy_ticks; // Ticks spent running a job
+    int dispatches;     // Jobs put on this CPU, stolen ones included
+    int steals;         // Jobs taken from another CPU's ready queue
+} CpuStats;
+
+typedef struct {
+    int cpus;           // 0 unless a multi-CPU run filled the report
+    SimTime total_time;
+    CpuStats *per_cpu;  // cpus entries
+} CpuReport;
+
+// Options for one simulation run
+typedef struct {
+    SchedulerPolicy policy;
+    SchedulerEngine engine;
+    int time_quantum;                 // Round-robin quantum
+    int mlfq_time_slice[MLFQ_NUM_QUEUES];  // MLFQ time slice per level (default MLFQ_TIME_SLICE_Q0..Q2)
+    int mlfq_boost_interval;          // MLFQ priority boost period (default MLFQ_BOOST_INTERVAL)
+    int fast_forward;                 // Tick engine: skip idle ticks and run a lone job in bursts (same output)
+    int cpus;                         // Simulated CPUs; more than one selects the multi-CPU engine (scheduler_smp.c)
+    int host_threads;                 // Multi-CPU engine: host threads sharing the per-CPU work (same results for any count)
+    SimRngKind rng;                   // Generator a run's SimContext is seeded with (default SIM_RNG_COMPAT)
+    SimTime horizon;                  // Tick engines: stop once the clock passes this tick (0: run to completion)
+    SubmissionQueue *submissions;     // Optional: jobs submitted while the simulation runs
+} SchedulerConfig;
+
 void init_global_info(Global_Info *info);
-void calculate_and_print_final_stats(Global_Info* info, Job** all_jobs, int n, int total_sim_time);
+void calculate_final_stats(Global_Info* info, Job** all_jobs, int n, SimTime total_sim_time);
+void calculate_and_print_final_stats(Global_Info* info, Job** all_jobs, int n, SimTime total_sim_time);
+
+void init_scheduler_config(SchedulerConfig *config);
+Job* take_submitted_job(SubmissionQueue *submissions, SimTime clock_tick, int idle);
+
+// Horizon checks for the tick loops
+SimTime horizon_limit(const SchedulerConfig *config);        // Last tick to simulate, SIM_TIME_MAX if none
+int past_horizon(const SchedulerConfig *config, SimTime clock);  // Reports and returns 1 once clock passes it
 
-void schedule(Job **jobs, int n, SchedulerPolicy policy, int time_quantum);
+// Queue instrumentation, no-ops unless sim->queue_stats is set
+void enable_queue_stats(const SimContext *sim, Queue *queue);
+void collect_queue_stats(SimContext *sim, const char *name, const Queue *queue);
+void print_queue_stats_report(const QueueStatsReport *report);
+void print_cpu_report(const CpuReport *report);
+// Each run reads and advances only its own SimContext (clock, random stream,
+// queue counters), so runs with separate contexts may execute concurrently.
+// config and the jobs' inputs are only read.
+int simulate(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config, CpuReport *cpu_report);  // Run only, 0 on success
+void schedule(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config);  // Run and print the report
+// Run on copies of jobs with a fresh context seeded with seed; jobs are only read
+int simulate_summary(Job **jobs, int n, const SchedulerConfig *config, unsigned int seed, Global_Info *info);
 
-void schedule_sjf(Job **jobs, int n);
-void schedule_rr(Job **jobs, int n, int time_quatum);
-void schedule_mlfq(Job **jobs, int n);
+void schedule_sjf(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config);
+void schedule_rr(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config);
+void schedule_mlfq(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config);
+void schedule_events(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config);  // Any policy, event engine
+void schedule_multicore(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config, CpuReport *report);  // Any policy, config->cpus CPUs
 
 
 #endif //SCHEDULER_H
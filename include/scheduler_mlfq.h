@@ -8,9 +8,10 @@
 
 #include "job.h"
 #include "queue.h"
+#include "scheduler.h"
 
-// MLFQ Configuration
-#define MLFQ_NUM_QUEUES 3
+// MLFQ Configuration (defaults for config->mlfq_time_slice / mlfq_boost_interval;
+// MLFQ_NUM_QUEUES is in scheduler.h)
 #define MLFQ_TIME_SLICE_Q0 8
 #define MLFQ_TIME_SLICE_Q1 16
 #define MLFQ_TIME_SLICE_Q2 32
@@ -19,21 +20,23 @@
 // Statistics structure
 typedef struct {
     int total_jobs;
-    int total_simulation_time;
-    int shortest_job_time;
-    int longest_job_time;
-    int total_ready_time;
-    int total_sleep_time;
+    SimTime total_simulation_time;
+    SimTime shortest_job_time;
+    SimTime longest_job_time;
+    SimTime total_ready_time;
+    SimTime total_sleep_time;
 } Statistics;
 
 // MLFQ structure to track job state
 typedef struct {
     int current_queue_level;    // Current queue level (0-2)
     int time_slice_used;        // Time used in current time slice
-    int total_time_in_queue[MLFQ_NUM_QUEUES];  // Time spent in each queue
+    SimTime total_time_in_queue[MLFQ_NUM_QUEUES];  // Time spent in each queue
+    SimTime since;              // First tick of the current queued/I/O span, charged when the job leaves
+    QueueNode link;             // Level/I/O queue links (intrusive, no per-enqueue allocation)
 } MLFQJobState;
 
 // MLFQ scheduler function
-void run_mlfq_scheduler(Job **jobs, int num_jobs);
+void run_mlfq_scheduler(SimContext *sim, Job **jobs, int num_jobs, const SchedulerConfig *config);
 
 #endif //SCHEDULER_MLFQ_H
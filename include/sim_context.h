@@ -0,0 +1,50 @@
+//
+// Simulation Context
+// Header File
+//
+
+#ifndef SIM_CONTEXT_H
+#define SIM_CONTEXT_H
+
+#include <stdint.h>
+
+#include "job.h"
+
+#define RAND_DEGREE 31
+
+// Random generator behind the I/O draws
+typedef enum {
+    SIM_RNG_COMPAT,     // Same sequence as glibc rand(), so results match the reference output
+    SIM_RNG_XOSHIRO,    // xoshiro256**: faster, unbiased Bernoulli draws, several per 64-bit word
+    SIM_RNG_KEYED       // Philox4x32-10 keyed by (seed, PID, tick, draw kind): no stream order at all
+} SimRngKind;
+
+// Generator state (see utils.c); only the fields of kind are used
+typedef struct {
+    SimRngKind kind;
+    int32_t state[RAND_DEGREE];     // SIM_RNG_COMPAT
+    int front;
+    int rear;
+    uint64_t xs[4];                 // SIM_RNG_XOSHIRO
+    uint32_t spare;                 // Unused low half of the last 64-bit output
+    int has_spare;
+    uint32_t key;                   // SIM_RNG_KEYED: the seed
+    uint64_t counter;               // SIM_RNG_KEYED: os_rand() calls so far
+} RandState;
+
+struct QueueStatsReport;
+
+// Everything one simulation run mutates besides its jobs: the clock, the
+// random stream behind the I/O draws and the queue counters. Schedulers
+// take it explicitly, so runs with separate contexts share no state and
+// can run concurrently in any threads.
+typedef struct {
+    SimTime clock;                          // Current tick
+    RandState rng;                          // I/O draws
+    struct QueueStatsReport *queue_stats;   // Optional: filled with per-queue counters
+} SimContext;
+
+// Clock at 0, generator of the given kind seeded with seed, no queue counters
+void init_sim_context(SimContext *sim, SimRngKind kind, unsigned int seed);
+
+#endif //SIM_CONTEXT_H
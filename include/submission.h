@@ -0,0 +1,47 @@
+//
+// Job Submission Queue
+// Lock-free multi-producer/single-consumer queue that feeds jobs into a
+// running simulation
+//
+
+#ifndef SUBMISSION_H
+#define SUBMISSION_H
+
+#include <stdatomic.h>
+
+#include "job.h"
+
+// Link in the submission list; allocated by the producer, freed by the consumer
+typedef struct SubmissionNode {
+    _Atomic(struct SubmissionNode *) next;
+    Job *job;
+} SubmissionNode;
+
+// Intrusive MPSC list (Vyukov): producers swap themselves into head with a
+// single atomic exchange, the scheduler consumes from tail. Neither side
+// ever waits for the other.
+typedef struct {
+    _Atomic(SubmissionNode *) head;  // Most recently submitted node (producers)
+    SubmissionNode *tail;            // Oldest node not yet taken (consumer only)
+    SubmissionNode stub;             // Placeholder that keeps the list non-empty
+    int capacity;                    // Maximum number of jobs that may be submitted
+    atomic_int reserved;             // Submission slots claimed so far
+    atomic_int in_flight;            // Producers currently inside submit_job()
+    atomic_int closed;               // Set once no more jobs will be submitted
+    Job **accepted;                  // Jobs taken by the consumer, in take order
+    int accepted_count;
+} SubmissionQueue;
+
+SubmissionQueue* create_submission_queue(int capacity);
+void destroy_submission_queue(SubmissionQueue *queue);  // Frees untaken nodes, never the jobs
+
+// Producer side (any thread)
+int submit_job(SubmissionQueue *queue, Job *job);  // 0 on success, -1 if closed or full
+void close_submissions(SubmissionQueue *queue);
+
+// Consumer side (the scheduler thread only)
+Job* take_submission(SubmissionQueue *queue);      // NULL if nothing is visible yet
+int submissions_finished(SubmissionQueue *queue);  // Closed and every submitted job taken
+int submission_capacity(const SubmissionQueue *queue);
+
+#endif //SUBMISSION_H
@@ -0,0 +1,50 @@
+//
+// Parameter Sweep
+// Header File
+//
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "job.h"
+#include "scheduler.h"
+
+// Largest number of configurations one sweep may expand to
+#define SWEEP_MAX_CONFIGS 100000
+#define SWEEP_MAX_VALUES 1024
+
+// Parameters a sweep can vary, in grid order (the last one varies fastest)
+typedef enum {
+    SWEEP_QUANTUM,      // RR time quantum
+    SWEEP_Q0,           // MLFQ time slices per level
+    SWEEP_Q1,
+    SWEEP_Q2,
+    SWEEP_BOOST,        // MLFQ boost interval
+    SWEEP_NUM_PARAMS
+} SweepParam;
+
+// Values of each swept parameter; a parameter with no values keeps the
+// base configuration's setting
+typedef struct {
+    int count[SWEEP_NUM_PARAMS];
+    int *values[SWEEP_NUM_PARAMS];
+} SweepGrid;
+
+void init_sweep_grid(SweepGrid *grid);
+void free_sweep_grid(SweepGrid *grid);
+
+// Adds "name=list" to the grid, where name is quantum, q0, q1, q2 or boost and
+// list is comma-separated values or lo:hi[:step] ranges, e.g. "q0=4,8:16:4".
+// Returns 0 on success, -1 on a malformed spec (already reported).
+int sweep_add_param(SweepGrid *grid, const char *spec);
+
+// Configurations in the grid (1 if nothing is swept)
+int sweep_grid_size(const SweepGrid *grid);
+
+// Runs every configuration of the grid on base (one simulation each, on a
+// pool of threads host threads, one per online CPU if threads <= 0) and prints
+// one summary row per configuration, in grid order. jobs is only read.
+// Returns 0 on success.
+int run_sweep(Job **jobs, int n, const SchedulerConfig *base, const SweepGrid *grid, int threads);
+
+#endif //SWEEP_H
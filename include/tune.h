@@ -0,0 +1,40 @@
+//
+// Round-Robin Quantum Tuning
+// Header File
+//
+
+#ifndef TUNE_H
+#define TUNE_H
+
+#include "job.h"
+#include "scheduler.h"
+
+#define TUNE_MAX_QUANTUM 1000000
+#define TUNE_CANDIDATES 16      // Starting quanta of the halving phase
+#define TUNE_MIN_JOBS 32        // Smallest job subset a candidate is scored on
+
+// Metric the tuner minimizes
+typedef enum {
+    TUNE_COMPLETION,    // Average job completion time
+    TUNE_READY,         // Average time in the ready queue
+    TUNE_SLEEP,         // Average time sleeping on I/O
+    TUNE_LONGEST,       // Longest job completion time
+    TUNE_TOTAL          // Total simulation run time
+} TuneMetric;
+
+// Parses completion, ready, sleep, longest or total. Returns 0 on success.
+int parse_tune_metric(const char *name, TuneMetric *out);
+
+// Searches quanta lo..hi for the one minimizing metric under base (an RR
+// configuration), on a pool of threads host threads (one per online CPU if
+// threads <= 0):
+//   1. successive halving: TUNE_CANDIDATES quanta spread geometrically over
+//      the range are scored on the earliest-arriving jobs, the better half
+//      kept and the job subset doubled until it is the whole input;
+//   2. golden-section search over the integers between the winner's
+//      neighbors, on the whole input.
+// Every run uses random seed 1, so the reported value matches a normal run with
+// that quantum. Prints the search and the best quantum. Returns 0 on success.
+int run_quantum_tuning(Job **jobs, int n, const SchedulerConfig *base, int lo, int hi, TuneMetric metric, int threads);
+
+#endif //TUNE_H
@@ -7,13 +7,39 @@
 
 #include <stdlib.h>
 
+#include "sim_context.h"
+
 #define CHANCE_OF_IO_REQUEST 10
 #define CHANCE_OF_IO_COMPLETE 4
 
-void os_srand(unsigned int seed);
-int os_rand(void);
+void os_srand(SimContext *sim, unsigned int seed);
+int os_rand(SimContext *sim);
+
+// One draw for job pid at the current tick (sim->clock). Only SIM_RNG_KEYED
+// uses pid and the tick: its outcome is a pure function of (seed, pid, tick,
+// request/complete), independent of the order jobs are visited in.
+int IO_request(SimContext *sim, int pid);
+int IO_complete(SimContext *sim, int pid);
+
+// Scratch for batched draws: the caller fills pids[0..count), a batch call
+// fills outcomes[0..count) with one IO_request()/IO_complete() draw each at
+// the current tick. With SIM_RNG_COMPAT the results equal count single calls
+// in order; with SIM_RNG_XOSHIRO several outcomes share a 64-bit word.
+typedef struct {
+    int *pids;
+    unsigned char *outcomes;
+} DrawBatch;
+
+int init_draw_batch(DrawBatch *batch, int capacity);  // 0 on success, -1 if out of memory
+void free_draw_batch(DrawBatch *batch);
+void IO_request_batch(SimContext *sim, DrawBatch *batch, int count);
+void IO_complete_batch(SimContext *sim, DrawBatch *batch, int count);
 
-int IO_request(void);
-int IO_complete(void);
+// Same distributions as repeated IO_request()/IO_complete() calls: the number of
+// calls up to and including the first one returning 1 (event engine), the
+// first made at first_tick. Keyed draws give exactly the count the tick loops
+// would see for pid; the other generators sample it from one draw.
+int ticks_until_IO_request(SimContext *sim, int pid, SimTime first_tick);
+int ticks_until_IO_complete(SimContext *sim, int pid, SimTime first_tick);
 
 #endif //UTILS_H
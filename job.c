@@ -14,7 +14,7 @@ void init_OutputBlock(OutputBlock *info) {
     memset(info, 0, sizeof(OutputBlock));
 }
 
-void init_Job(Job **job, int pid, int arrival, int service, int priority){
+void init_Job(Job **job, int pid, SimTime arrival, SimTime service, int priority){
     *job = (Job*)malloc(sizeof(Job));
     if (*job == NULL) {
         fprintf(stderr, "Error: memory allocation failed for Job\n");
@@ -59,3 +59,27 @@ void run(Job *job) {
     }
     job->info.total++;
 }
+
+// Span versions of wait()/sleep()/run(): account several ticks at once
+void wait_span(Job *job, SimTime ticks) {
+    if (job == NULL || ticks <= 0) {
+        return;
+    }
+    job->info.ready += ticks;
+    job->info.total += ticks;
+}
+
+void sleep_span(Job *job, SimTime ticks) {
+    if (job == NULL || ticks <= 0) {
+        return;
+    }
+    job->info.sleep += ticks;
+    job->info.total += ticks;
+}
+
+void run_span(Job *job, SimTime ticks) {
+    if (job == NULL || ticks <= 0) {
+        return;
+    }
+    job->info.total += ticks;
+}
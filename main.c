@@ -2,10 +2,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <pthread.h>
 
 #include "include/job.h"
 #include "include/scheduler.h"
 #include "include/utils.h"
+#include "include/pid_index.h"
+#include "include/sweep.h"
+#include "include/replicate.h"
+#include "include/compare.h"
+#include "include/tune.h"
 
 static void trim_trailing(char *s) {
     if (s == NULL) return;
@@ -17,11 +23,48 @@ static void trim_trailing(char *s) {
 
 static void print_usage(const char *prog) {
     fprintf(stderr,
-            "Usage: %s [--policy sjf|rr|mlfq] [--quantum N]\n"
+            "Usage: %s [--policy sjf|rr|mlfq|all] [--quantum N] [--engine tick|event]\n"
+            "       [--fast-forward] [--horizon T] [--stream [--max-jobs N]] [--queue-stats]\n"
+            "       [--cpus N [--threads N]] [--sweep NAME=VALUES ...] [--rng compat|xoshiro|keyed]\n"
+            "       [--replications N [--ci-width PCT]] [--tune-quantum LO:HI [--tune-metric NAME]]\n"
             "Reads job definitions from stdin in the format PID:Arrival:Service:Priority.\n"
+            "--policy all runs SJF, RR (--quantum) and MLFQ in parallel on one parse of the\n"
+            "input and prints their results side by side.\n"
+            "With --stream, jobs are submitted to the running simulation as they are read.\n"
+            "--engine event jumps between scheduling events instead of simulating every tick;\n"
+            "I/O timings are drawn per burst, so results match the tick engine statistically.\n"
+            "--fast-forward skips idle ticks and runs a lone job in bursts (tick engine, same output).\n"
+            "--horizon T stops the simulation once the clock passes tick T (tick engine); by\n"
+            "default it runs until every job completes.\n"
+            "With --queue-stats, per-queue operation counts are printed after the results.\n"
+            "--cpus N simulates N CPUs with per-CPU ready queues and work stealing (tick engine),\n"
+            "and prints per-CPU utilization after the results. --threads N spreads the per-CPU\n"
+            "work over N host threads; results do not depend on N.\n"
+            "--sweep NAME=VALUES (repeatable; NAME is quantum, q0, q1, q2 or boost, VALUES a\n"
+            "comma list of N or lo:hi[:step]) runs every combination on a pool of --threads\n"
+            "threads (default: online CPUs) and prints one summary row per configuration.\n"
+            "--rng xoshiro draws I/O events from a faster generator; the default compat\n"
+            "reproduces the rand() sequence of the reference output. --rng keyed makes each\n"
+            "I/O outcome a function of (seed, PID, tick) only.\n"
+            "--replications N runs up to N seeds (seed 1 is the normal run) on a pool of\n"
+            "--threads threads and prints each metric's mean and 95%% confidence interval;\n"
+            "--ci-width PCT stops once every interval is within PCT percent of its mean.\n"
+            "--tune-quantum LO:HI (rr) searches LO..HI for the quantum with the lowest\n"
+            "--tune-metric (completion, ready, sleep, longest or total; default completion)\n"
+            "by successive halving on subsets of the jobs, then golden-section search.\n"
             "Examples:\n"
             "  %s --policy sjf < input.txt\n"
-            "  %s --policy rr --quantum 4 < input.txt\n",
+            "  %s --policy rr --quantum 4 < input.txt\n"
+            "  %s --policy all --quantum 4 < input.txt\n"
+            "  %s --policy rr --tune-quantum 1:200 --tune-metric ready < input.txt\n"
+            "  %s --policy mlfq --sweep q0=4,8 --sweep boost=50:200:50 < input.txt\n"
+            "  %s --policy rr --quantum 4 --replications 200 --ci-width 1 < input.txt\n"
+            "  producer | %s --policy sjf --stream\n",
+            prog,
+            prog,
+            prog,
+            prog,
+            prog,
             prog,
             prog,
             prog);
@@ -47,11 +90,138 @@ static int parse_policy(const char *arg, SchedulerPolicy *out_policy) {
     return -1;
 }
 
+// Parses one input line into a new Job.
+// Returns 0 with *out set, 1 for blank/comment lines, -1 on error (already reported).
+static int parse_job_line(char *line, PidIndex *pid_index, Job **out) {
+    trim_trailing(line);
+
+    // skip empty or comment lines
+    char *p = line;
+    while (isspace((unsigned char)*p)) p++;
+    if (*p == '\0' || *p == '#') return 1;
+
+    int pid, priority;
+    long long arrival, service;
+    if (sscanf(p, "%d:%lld:%lld:%d", &pid, &arrival, &service, &priority) != 4) {
+        fprintf(stderr, "Invalid line: %s\n", line);
+        return -1;
+    }
+    if (arrival < 0 || service <= 0) {
+        fprintf(stderr, "Invalid values (arrival>=0, service>0): %s\n", line);
+        return -1;
+    }
+
+    Job *job = NULL;
+    init_Job(&job, pid, arrival, service, priority);
+    if (job == NULL) {
+        return -1;
+    }
+
+    int inserted = pid_index_insert(pid_index, pid, job);
+    if (inserted == 1) {
+        fprintf(stderr, "Duplicate PID %d: %s\n", pid, line);
+        free(job);
+        return -1;
+    }
+    if (inserted != 0) {
+        fprintf(stderr, "Out of memory\n");
+        free(job);
+        return -1;
+    }
+
+    *out = job;
+    return 0;
+}
+
+typedef struct {
+    SubmissionQueue *submissions;
+    int failed;
+} ProducerArgs;
+
+// Producer thread for --stream: submits each job as soon as it is parsed
+static void *stream_jobs(void *arg) {
+    ProducerArgs *args = (ProducerArgs*)arg;
+    char line[256];
+
+    PidIndex *pid_index = create_pid_index(0);
+    if (pid_index == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        args->failed = 1;
+        close_submissions(args->submissions);
+        return NULL;
+    }
+
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        Job *job = NULL;
+        int parsed = parse_job_line(line, pid_index, &job);
+        if (parsed == 1) continue;
+        if (parsed != 0) {
+            args->failed = 1;
+            break;
+        }
+        if (submit_job(args->submissions, job) != 0) {
+            fprintf(stderr, "Too many jobs (limit %d), see --max-jobs\n",
+                    submission_capacity(args->submissions));
+            free(job);
+            args->failed = 1;
+            break;
+        }
+    }
+
+    close_submissions(args->submissions);
+    destroy_pid_index(pid_index);
+    return NULL;
+}
+
+static int run_stream(const char *policy_arg, SimContext *sim, SchedulerConfig *config, int max_jobs) {
+    SubmissionQueue *submissions = create_submission_queue(max_jobs);
+    if (submissions == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    config->submissions = submissions;
+
+    ProducerArgs args = { submissions, 0 };
+    pthread_t producer;
+    if (pthread_create(&producer, NULL, stream_jobs, &args) != 0) {
+        fprintf(stderr, "Error: failed to start producer thread\n");
+        destroy_submission_queue(submissions);
+        return 1;
+    }
+
+    printf("Streaming jobs from stdin. Dispatching policy: %s\n", policy_arg);
+    schedule(sim, NULL, 0, config);
+    pthread_join(producer, NULL);
+
+    for (int i = 0; i < submissions->accepted_count; ++i) {
+        free(submissions->accepted[i]);
+    }
+    destroy_submission_queue(submissions);
+    config->submissions = NULL;
+
+    return args.failed ? 1 : 0;
+}
+
 int main(int argc, char *argv[]){
-    os_srand(1);
-    
     const char *policy_arg = "sjf";
     int time_quantum = 0;
+    int stream = 0;
+    int max_jobs = 65536;
+    int queue_stats = 0;
+    int fast_forward = 0;
+    SimTime horizon = 0;    // 0: run to completion
+    int cpus = 1;
+    int host_threads = 0;   // 0: not given
+    SchedulerEngine engine = SCHED_ENGINE_TICK;
+    SimRngKind rng = SIM_RNG_COMPAT;
+    int sweep = 0;
+    int replications = 0;   // 0: single run
+    double ci_width = 0.0;  // Percent of the mean, 0: no early stop
+    int tune = 0;
+    int tune_lo = 0, tune_hi = 0;
+    TuneMetric tune_metric = TUNE_COMPLETION;
+    SweepGrid grid;
+    init_sweep_grid(&grid);
 
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "--policy") == 0 || strcmp(argv[i], "-p") == 0) {
@@ -68,6 +238,144 @@ int main(int argc, char *argv[]){
                 return 1;
             }
             time_quantum = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = 1;
+        } else if (strcmp(argv[i], "--max-jobs") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --max-jobs requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            max_jobs = atoi(argv[++i]);
+            if (max_jobs <= 0) {
+                fprintf(stderr, "Error: --max-jobs must be positive\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--engine") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --engine requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            const char *engine_arg = argv[++i];
+            if (strcmp(engine_arg, "tick") == 0) {
+                engine = SCHED_ENGINE_TICK;
+            } else if (strcmp(engine_arg, "event") == 0) {
+                engine = SCHED_ENGINE_EVENT;
+            } else {
+                fprintf(stderr, "Error: unknown engine '%s'. Expected tick or event.\n", engine_arg);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--rng") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --rng requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            const char *rng_arg = argv[++i];
+            if (strcmp(rng_arg, "compat") == 0) {
+                rng = SIM_RNG_COMPAT;
+            } else if (strcmp(rng_arg, "xoshiro") == 0) {
+                rng = SIM_RNG_XOSHIRO;
+            } else if (strcmp(rng_arg, "keyed") == 0) {
+                rng = SIM_RNG_KEYED;
+            } else {
+                fprintf(stderr, "Error: unknown generator '%s'. Expected compat, xoshiro or keyed.\n", rng_arg);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--fast-forward") == 0) {
+            fast_forward = 1;
+        } else if (strcmp(argv[i], "--horizon") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --horizon requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            horizon = atoll(argv[++i]);
+            if (horizon <= 0) {
+                fprintf(stderr, "Error: --horizon must be positive\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--cpus") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --cpus requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            cpus = atoi(argv[++i]);
+            if (cpus <= 0) {
+                fprintf(stderr, "Error: --cpus must be positive\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --threads requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            host_threads = atoi(argv[++i]);
+            if (host_threads <= 0) {
+                fprintf(stderr, "Error: --threads must be positive\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --sweep requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            if (sweep_add_param(&grid, argv[++i]) != 0) {
+                free_sweep_grid(&grid);
+                return 1;
+            }
+            sweep = 1;
+        } else if (strcmp(argv[i], "--replications") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --replications requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            replications = atoi(argv[++i]);
+            if (replications <= 0 || replications > REPLICATE_MAX_RUNS) {
+                fprintf(stderr, "Error: --replications must be between 1 and %d\n", REPLICATE_MAX_RUNS);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--ci-width") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --ci-width requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            ci_width = atof(argv[++i]);
+            if (!(ci_width > 0.0)) {
+                fprintf(stderr, "Error: --ci-width must be a positive percentage\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--tune-quantum") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --tune-quantum requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            char extra;
+            if (sscanf(argv[++i], "%d:%d%c", &tune_lo, &tune_hi, &extra) != 2 ||
+                tune_lo <= 0 || tune_hi < tune_lo || tune_hi > TUNE_MAX_QUANTUM) {
+                fprintf(stderr, "Error: --tune-quantum expects LO:HI with 1 <= LO <= HI <= %d\n", TUNE_MAX_QUANTUM);
+                return 1;
+            }
+            tune = 1;
+        } else if (strcmp(argv[i], "--tune-metric") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --tune-metric requires an argument\n");
+                print_usage(argv[0]);
+                return 1;
+            }
+            if (parse_tune_metric(argv[++i], &tune_metric) != 0) {
+                fprintf(stderr, "Error: unknown metric '%s'. Expected completion, ready, sleep, longest or total.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--queue-stats") == 0) {
+            queue_stats = 1;
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -78,39 +386,121 @@ int main(int argc, char *argv[]){
         }
     }
 
-    SchedulerPolicy policy;
-    if (parse_policy(policy_arg, &policy) != 0) {
-        fprintf(stderr, "Error: unknown policy '%s'. Expected sjf, rr, or mlfq.\n", policy_arg);
+    SchedulerPolicy policy = SCHED_POLICY_SJF;
+    int all_policies = strcmp(policy_arg, "all") == 0;
+    if (!all_policies && parse_policy(policy_arg, &policy) != 0) {
+        fprintf(stderr, "Error: unknown policy '%s'. Expected sjf, rr, mlfq or all.\n", policy_arg);
         print_usage(argv[0]);
         return 1;
     }
 
-    if (policy == SCHED_POLICY_RR && time_quantum <= 0) {
+    if (tune) {
+        if (policy != SCHED_POLICY_RR || all_policies) {
+            fprintf(stderr, "Error: --tune-quantum requires --policy rr.\n");
+            return 1;
+        }
+        if (stream || sweep || replications > 0) {
+            fprintf(stderr, "Error: --tune-quantum cannot be combined with --stream, --sweep or --replications.\n");
+            free_sweep_grid(&grid);
+            return 1;
+        }
+    }
+
+    if ((policy == SCHED_POLICY_RR || all_policies) && time_quantum <= 0 && grid.count[SWEEP_QUANTUM] == 0 && !tune) {
         fprintf(stderr, "Error: round-robin policy requires a positive --quantum value.\n");
         return 1;
     }
 
+    if (all_policies) {
+#if defined(BUILD_SJF_ONLY) || defined(BUILD_RR_ONLY) || defined(BUILD_MLFQ_ONLY)
+        fprintf(stderr, "Error: this binary only supports one policy.\n");
+        return 1;
+#endif
+        if (stream || sweep || replications > 0) {
+            fprintf(stderr, "Error: --policy all cannot be combined with --stream, --sweep or --replications.\n");
+            free_sweep_grid(&grid);
+            return 1;
+        }
+    }
+
+    if (ci_width > 0.0 && replications == 0) {
+        fprintf(stderr, "Error: --ci-width requires --replications.\n");
+        return 1;
+    }
+
+    if (replications > 0 && sweep) {
+        fprintf(stderr, "Error: --replications cannot be combined with --sweep.\n");
+        free_sweep_grid(&grid);
+        return 1;
+    }
+
+    if (horizon > 0 && engine == SCHED_ENGINE_EVENT) {
+        fprintf(stderr, "Error: --horizon requires the tick engine.\n");
+        return 1;
+    }
+
+    if (cpus > 1 && engine == SCHED_ENGINE_EVENT) {
+        fprintf(stderr, "Error: --cpus requires the tick engine.\n");
+        return 1;
+    }
+
+    SchedulerConfig config;
+    init_scheduler_config(&config);
+    config.policy = policy;
+    config.time_quantum = time_quantum;
+    config.engine = engine;
+    config.fast_forward = fast_forward;
+    config.cpus = cpus;
+    config.host_threads = (host_threads > 0) ? host_threads : 1;
+    config.rng = rng;
+    config.horizon = horizon;
+
+    SimContext sim;
+    init_sim_context(&sim, config.rng, 1);
+    QueueStatsReport queue_report = { 0 };
+    if (queue_stats) {
+        sim.queue_stats = &queue_report;
+    }
+
+    if (stream) {
+        if (engine == SCHED_ENGINE_EVENT) {
+            fprintf(stderr, "Error: --stream requires the tick engine.\n");
+            return 1;
+        }
+        if (cpus > 1) {
+            fprintf(stderr, "Error: --stream supports a single CPU only.\n");
+            return 1;
+        }
+        if (sweep) {
+            fprintf(stderr, "Error: --sweep reads the whole input first and cannot be used with --stream.\n");
+            free_sweep_grid(&grid);
+            return 1;
+        }
+        if (replications > 0) {
+            fprintf(stderr, "Error: --replications reads the whole input first and cannot be used with --stream.\n");
+            return 1;
+        }
+        return run_stream(policy_arg, &sim, &config, max_jobs);
+    }
+
     char line[256];
 
     Job **jobs = NULL;
     size_t count = 0;
     size_t capacity = 0;
 
-    while (fgets(line, sizeof(line), stdin) != NULL) {
-        trim_trailing(line);
-
-        // skip empty or comment lines
-        char *p = line;
-        while (isspace((unsigned char)*p)) p++;
-        if (*p == '\0' || *p == '#') continue;
+    // PID -> Job index, used to reject duplicate PIDs in O(1) per line
+    PidIndex *pid_index = create_pid_index(0);
+    if (pid_index == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
 
-        int pid, arrival, service, priority;
-        if (sscanf(p, "%d:%d:%d:%d", &pid, &arrival, &service, &priority) != 4) {
-            fprintf(stderr, "Invalid line: %s\n", line);
-            return 1;
-        }
-        if (arrival < 0 || service <= 0) {
-            fprintf(stderr, "Invalid values (arrival>=0, service>0): %s\n", line);
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        Job *job = NULL;
+        int parsed = parse_job_line(line, pid_index, &job);
+        if (parsed == 1) continue;
+        if (parsed != 0) {
             return 1;
         }
 
@@ -124,10 +514,9 @@ int main(int argc, char *argv[]){
             jobs = tmp;
             capacity = newcap;
         }
-
-        init_Job(&jobs[count], pid, arrival, service, priority);
-        count++;
+        jobs[count++] = job;
     }
+    destroy_pid_index(pid_index);
 
     if (count == 0) {
         fprintf(stderr, "No jobs found in input.\n");
@@ -136,7 +525,19 @@ int main(int argc, char *argv[]){
     }
 
     printf("Loaded %zu job(s). Dispatching policy: %s\n", count, policy_arg);
-    schedule(jobs, (int)count, policy, time_quantum);
+    int status = 0;
+    if (sweep) {
+        status = (run_sweep(jobs, (int)count, &config, &grid, host_threads) == 0) ? 0 : 1;
+        free_sweep_grid(&grid);
+    } else if (tune) {
+        status = (run_quantum_tuning(jobs, (int)count, &config, tune_lo, tune_hi, tune_metric, host_threads) == 0) ? 0 : 1;
+    } else if (all_policies) {
+        status = (run_policy_comparison(jobs, (int)count, &config) == 0) ? 0 : 1;
+    } else if (replications > 0) {
+        status = (run_replications(jobs, (int)count, &config, replications, ci_width / 100.0, host_threads) == 0) ? 0 : 1;
+    } else {
+        schedule(&sim, jobs, (int)count, &config);
+    }
 
     for (size_t i = 0; i < count; ++i) {
         free(jobs[i]);
@@ -144,5 +545,5 @@ int main(int argc, char *argv[]){
 
     free(jobs);
 
-    return 0;
+    return status;
 }
\ No newline at end of file
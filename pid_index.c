@@ -0,0 +1,176 @@
+//
+// PID Index
+// Implementation File
+//
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "include/pid_index.h"
+
+#define PID_INDEX_MIN_SHIFT 4
+#define PID_INDEX_MIN_CAPACITY (1 << PID_INDEX_MIN_SHIFT)
+
+// Fibonacci hashing: the top bits of the product depend on every bit of
+// the PID, so strided PIDs (multiples of a power of two) spread out as
+// well as consecutive ones. The low bits would only see the PID's low bits.
+static int home_slot(const PidIndex *index, int pid) {
+    return (int)((uint32_t)((uint32_t)pid * 2654435769u) >> index->shift);
+}
+
+static PidIndexSlot* allocate_slots(int capacity) {
+    return (PidIndexSlot*)calloc(capacity, sizeof(PidIndexSlot));
+}
+
+// Double the table and re-insert every entry
+static int grow(PidIndex *index) {
+    int old_capacity = index->capacity;
+    PidIndexSlot *old_slots = index->slots;
+
+    PidIndexSlot *slots = allocate_slots(old_capacity * 2);
+    if (slots == NULL) {
+        return -1;
+    }
+    index->slots = slots;
+    index->capacity = old_capacity * 2;
+    index->shift--;
+
+    int mask = index->capacity - 1;
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_slots[i].value == NULL) {
+            continue;
+        }
+        int slot = home_slot(index, old_slots[i].pid);
+        while (index->slots[slot].value != NULL) {
+            slot = (slot + 1) & mask;
+        }
+        index->slots[slot] = old_slots[i];
+    }
+    free(old_slots);
+    return 0;
+}
+
+PidIndex* create_pid_index(int expected_count) {
+    PidIndex *index = (PidIndex*)malloc(sizeof(PidIndex));
+    if (index == NULL) {
+        return NULL;
+    }
+
+    int capacity = PID_INDEX_MIN_CAPACITY;
+    int shift = 32 - PID_INDEX_MIN_SHIFT;
+    while (capacity < expected_count * 2) {
+        capacity *= 2;
+        shift--;
+    }
+
+    index->slots = allocate_slots(capacity);
+    if (index->slots == NULL) {
+        free(index);
+        return NULL;
+    }
+    index->capacity = capacity;
+    index->shift = shift;
+    index->count = 0;
+    return index;
+}
+
+void destroy_pid_index(PidIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    free(index->slots);
+    free(index);
+}
+
+void clear_pid_index(PidIndex *index) {
+    if (index == NULL || index->count == 0) {
+        return;
+    }
+    for (int i = 0; i < index->capacity; i++) {
+        index->slots[i].value = NULL;
+    }
+    index->count = 0;
+}
+
+int pid_index_insert(PidIndex *index, int pid, void *value) {
+    if (index == NULL || value == NULL) {
+        return -1;
+    }
+
+    if ((index->count + 1) * 2 > index->capacity && grow(index) != 0) {
+        return -1;
+    }
+
+    int mask = index->capacity - 1;
+    int slot = home_slot(index, pid);
+    while (index->slots[slot].value != NULL) {
+        if (index->slots[slot].pid == pid) {
+            return 1;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    index->slots[slot].pid = pid;
+    index->slots[slot].value = value;
+    index->count++;
+    return 0;
+}
+
+int pid_index_reserve(PidIndex *index, int extra) {
+    if (index == NULL) {
+        return -1;
+    }
+    while ((index->count + extra) * 2 > index->capacity) {
+        if (grow(index) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void* pid_index_find(const PidIndex *index, int pid) {
+    if (index == NULL) {
+        return NULL;
+    }
+
+    int mask = index->capacity - 1;
+    int slot = home_slot(index, pid);
+    while (index->slots[slot].value != NULL) {
+        if (index->slots[slot].pid == pid) {
+            return index->slots[slot].value;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+// Backward-shift deletion: no tombstones, so lookups never slow down
+void pid_index_remove(PidIndex *index, int pid) {
+    if (index == NULL) {
+        return;
+    }
+
+    int mask = index->capacity - 1;
+    int slot = home_slot(index, pid);
+    while (index->slots[slot].value != NULL && index->slots[slot].pid != pid) {
+        slot = (slot + 1) & mask;
+    }
+    if (index->slots[slot].value == NULL) {
+        return;
+    }
+
+    // Pull later entries of the probe run back into the hole
+    int hole = slot;
+    int next = (hole + 1) & mask;
+    while (index->slots[next].value != NULL) {
+        int home = home_slot(index, index->slots[next].pid);
+        // Entry may move into the hole only if its home is not inside (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->slots[hole] = index->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index->slots[hole].value = NULL;
+    index->count--;
+}
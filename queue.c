@@ -4,20 +4,344 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "../include/queue.h"
+#include "../include/pid_index.h"
 
-// Create a new queue node
-static QueueNode* create_node(Job *job, int remaining_time) {
-    QueueNode *node = (QueueNode*)malloc(sizeof(QueueNode));
-    if (node == NULL) {
+#define HEAP_INITIAL_CAPACITY 16
+#define QUEUE_NODE_SLAB_SIZE 64
+#define RING_INITIAL_CAPACITY 16
+
+// Refill the queue's free list with a fresh slab of nodes
+static int grow_node_pool(Queue *queue) {
+    QueueNodeSlab *slab = (QueueNodeSlab*)malloc(sizeof(QueueNodeSlab) + QUEUE_NODE_SLAB_SIZE * sizeof(QueueNode));
+    if (slab == NULL) {
+        return -1;
+    }
+    slab->next = queue->slabs;
+    queue->slabs = slab;
+
+    for (int i = 0; i < QUEUE_NODE_SLAB_SIZE; i++) {
+        slab->nodes[i].next = queue->free_nodes;
+        queue->free_nodes = &slab->nodes[i];
+    }
+    return 0;
+}
+
+// Take a node from the queue's pool; only allocates when the pool is empty
+static QueueNode* create_node(Queue *queue, Job *job, SimTime remaining_time) {
+    if (queue->free_nodes == NULL && grow_node_pool(queue) != 0) {
         return NULL;
     }
+    QueueNode *node = queue->free_nodes;
+    queue->free_nodes = node->next;
+
     node->job = job;
     node->remaining_time = remaining_time;
     node->next = NULL;
+    node->prev = NULL;
+    node->seq = 0;
+    node->heap_index = -1;
+    node->pooled = 1;
+    node->linked = 0;
     return node;
 }
 
+// Return a node to the queue's pool. Caller-owned nodes are left alone.
+static void release_node(Queue *queue, QueueNode *node) {
+    if (!node->pooled) {
+        return;
+    }
+    node->next = queue->free_nodes;
+    queue->free_nodes = node;
+}
+
+// Keep the optional PID index in step with queue membership. Returns -1
+// when the index cannot grow; a PID that is already indexed is left as is.
+static int index_add(Queue *queue, Job *job) {
+    if (queue->pid_index != NULL && pid_index_insert(queue->pid_index, job->PID, job) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Make room in the PID index for extra more jobs, so bulk moves cannot fail halfway
+static int index_reserve(Queue *queue, int extra) {
+    if (queue->pid_index != NULL) {
+        return pid_index_reserve(queue->pid_index, extra);
+    }
+    return 0;
+}
+
+static void index_drop(Queue *queue, const Job *job) {
+    if (queue->pid_index != NULL) {
+        pid_index_remove(queue->pid_index, job->PID);
+    }
+}
+
+// Operation counters; all of these are no-ops unless queue_enable_stats() was called
+static void stats_sample_depth(const Queue *queue) {
+    QueueStats *stats = queue->stats;
+    if (queue->size > stats->max_depth) {
+        stats->max_depth = queue->size;
+    }
+    stats->depth_sum += (unsigned long)queue->size;
+    stats->depth_samples++;
+}
+
+static void stats_enqueued(const Queue *queue, int count) {
+    if (queue->stats != NULL) {
+        queue->stats->enqueues += (unsigned long)count;
+        stats_sample_depth(queue);
+    }
+}
+
+static void stats_dequeued(const Queue *queue, int count) {
+    if (queue->stats != NULL) {
+        queue->stats->dequeues += (unsigned long)count;
+        stats_sample_depth(queue);
+    }
+}
+
+static void stats_removed(const Queue *queue) {
+    if (queue->stats != NULL) {
+        queue->stats->removals++;
+        stats_sample_depth(queue);
+    }
+}
+
+static void stats_insert_steps(const Queue *queue, int steps) {
+    if (queue->stats != NULL) {
+        queue->stats->insert_steps += (unsigned long)steps;
+    }
+}
+
+static void stats_remove_steps(const Queue *queue, int steps) {
+    if (queue->stats != NULL) {
+        queue->stats->remove_steps += (unsigned long)steps;
+    }
+}
+
+static int is_heap_queue(const Queue *queue) {
+    return queue->type == QUEUE_SJF_HEAP || queue->type == QUEUE_PRIORITY_HEAP;
+}
+
+// Ordering of heap-backed queues. Matches the list versions: key first,
+// then PID, then insertion order (the list inserts after equal keys).
+static int heap_node_before(const Queue *queue, const QueueNode *a, const QueueNode *b) {
+    if (queue->type == QUEUE_SJF_HEAP) {
+        if (a->remaining_time != b->remaining_time) {
+            return a->remaining_time < b->remaining_time;
+        }
+    } else {
+        if (a->job->priority != b->job->priority) {
+            return a->job->priority < b->job->priority;
+        }
+    }
+    if (a->job->PID != b->job->PID) {
+        return a->job->PID < b->job->PID;
+    }
+    return a->seq < b->seq;
+}
+
+// Sift helpers return the number of levels the node moved
+static int heap_sift_up(Queue *queue, int index) {
+    QueueNode *node = queue->heap[index];
+    int steps = 0;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!heap_node_before(queue, node, queue->heap[parent])) {
+            break;
+        }
+        queue->heap[index] = queue->heap[parent];
+        queue->heap[index]->heap_index = index;
+        index = parent;
+        steps++;
+    }
+    queue->heap[index] = node;
+    node->heap_index = index;
+    return steps;
+}
+
+static int heap_sift_down(Queue *queue, int index) {
+    QueueNode *node = queue->heap[index];
+    int half = queue->size / 2;
+    int steps = 0;
+    while (index < half) {
+        int child = 2 * index + 1;
+        if (child + 1 < queue->size &&
+            heap_node_before(queue, queue->heap[child + 1], queue->heap[child])) {
+            child++;
+        }
+        if (!heap_node_before(queue, queue->heap[child], node)) {
+            break;
+        }
+        queue->heap[index] = queue->heap[child];
+        queue->heap[index]->heap_index = index;
+        index = child;
+        steps++;
+    }
+    queue->heap[index] = node;
+    node->heap_index = index;
+    return steps;
+}
+
+// Make room for extra more nodes in the heap array
+static int heap_reserve(Queue *queue, int extra) {
+    if (queue->size + extra <= queue->heap_capacity) {
+        return 0;
+    }
+
+    int new_capacity = queue->heap_capacity == 0 ? HEAP_INITIAL_CAPACITY : queue->heap_capacity;
+    while (new_capacity < queue->size + extra) {
+        new_capacity *= 2;
+    }
+    QueueNode **tmp = (QueueNode**)realloc(queue->heap, new_capacity * sizeof(QueueNode*));
+    if (tmp == NULL) {
+        return -1;
+    }
+    queue->heap = tmp;
+    queue->heap_capacity = new_capacity;
+    return 0;
+}
+
+// Remove the node at heap slot index and restore the heap property
+static QueueNode* heap_remove_at(Queue *queue, int index) {
+    QueueNode *node = queue->heap[index];
+    queue->size--;
+    if (index != queue->size) {
+        queue->heap[index] = queue->heap[queue->size];
+        int steps = heap_sift_down(queue, index);
+        steps += heap_sift_up(queue, index);
+        stats_remove_steps(queue, steps);
+    }
+    return node;
+}
+
+// Find the node holding job (linear scan, used by the job-based API)
+static QueueNode* find_node(Queue *queue, const Job *job) {
+    if (is_heap_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            if (queue->heap[i]->job == job) {
+                stats_remove_steps(queue, i);
+                return queue->heap[i];
+            }
+        }
+        stats_remove_steps(queue, queue->size);
+        return NULL;
+    }
+
+    QueueNode *current = queue->head;
+    int steps = 0;
+    while (current != NULL && current->job != job) {
+        current = current->next;
+        steps++;
+    }
+    stats_remove_steps(queue, steps);
+    return current;
+}
+
+static int is_ring_queue(const Queue *queue) {
+    return queue->type == QUEUE_FIFO_RING;
+}
+
+// Slot of the index-th job in ring order
+static QueueRingEntry* ring_entry(const Queue *queue, int index) {
+    return &queue->ring[(queue->ring_head + index) & (queue->ring_capacity - 1)];
+}
+
+// Make room for extra more jobs, unwrapping the ring into a larger buffer
+static int ring_reserve(Queue *queue, int extra) {
+    if (queue->size + extra <= queue->ring_capacity) {
+        return 0;
+    }
+
+    int new_capacity = queue->ring_capacity == 0 ? RING_INITIAL_CAPACITY : queue->ring_capacity;
+    while (new_capacity < queue->size + extra) {
+        new_capacity *= 2;
+    }
+    QueueRingEntry *ring = (QueueRingEntry*)malloc(new_capacity * sizeof(QueueRingEntry));
+    if (ring == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < queue->size; i++) {
+        ring[i] = *ring_entry(queue, i);
+    }
+    free(queue->ring);
+    queue->ring = ring;
+    queue->ring_capacity = new_capacity;
+    queue->ring_head = 0;
+    queue->ring_tail = queue->size;
+    return 0;
+}
+
+static int ring_push(Queue *queue, Job *job, SimTime remaining_time, QueueNode *node) {
+    if (ring_reserve(queue, 1) != 0 || index_add(queue, job) != 0) {
+        return -1;
+    }
+    QueueRingEntry *entry = &queue->ring[queue->ring_tail];
+    entry->job = job;
+    entry->remaining_time = remaining_time;
+    entry->node = node;
+    if (node != NULL) {
+        node->linked = 1;
+    }
+    queue->ring_tail = (queue->ring_tail + 1) & (queue->ring_capacity - 1);
+    queue->size++;
+    stats_enqueued(queue, 1);
+    return 0;
+}
+
+static QueueRingEntry ring_pop(Queue *queue) {
+    QueueRingEntry entry = queue->ring[queue->ring_head];
+    queue->ring_head = (queue->ring_head + 1) & (queue->ring_capacity - 1);
+    queue->size--;
+    if (entry.node != NULL) {
+        entry.node->linked = 0;
+    }
+    index_drop(queue, entry.job);
+    stats_dequeued(queue, 1);
+    return entry;
+}
+
+// Remove the index-th job, shifting the jobs behind it forward one slot
+static void ring_remove_at(Queue *queue, int index) {
+    QueueRingEntry *removed = ring_entry(queue, index);
+    if (removed->node != NULL) {
+        removed->node->linked = 0;
+    }
+    index_drop(queue, removed->job);
+    for (int i = index; i < queue->size - 1; i++) {
+        *ring_entry(queue, i) = *ring_entry(queue, i + 1);
+    }
+    queue->size--;
+    queue->ring_tail = (queue->ring_tail - 1) & (queue->ring_capacity - 1);
+    stats_remove_steps(queue, queue->size - index);
+    stats_removed(queue);
+}
+
+static int ring_find_job(const Queue *queue, const Job *job) {
+    for (int i = 0; i < queue->size; i++) {
+        if (ring_entry(queue, i)->job == job) {
+            stats_remove_steps(queue, i);
+            return i;
+        }
+    }
+    stats_remove_steps(queue, queue->size);
+    return -1;
+}
+
+static int ring_find_node(const Queue *queue, const QueueNode *node) {
+    for (int i = 0; i < queue->size; i++) {
+        if (ring_entry(queue, i)->node == node) {
+            stats_remove_steps(queue, i);
+            return i;
+        }
+    }
+    stats_remove_steps(queue, queue->size);
+    return -1;
+}
+
 // Create a new queue
 Queue* create_queue(QueueType type) {
     Queue *queue = (Queue*)malloc(sizeof(Queue));
@@ -29,6 +353,17 @@ Queue* create_queue(QueueType type) {
     queue->tail = NULL;
     queue->size = 0;
     queue->type = type;
+    queue->heap = NULL;
+    queue->heap_capacity = 0;
+    queue->next_seq = 0;
+    queue->free_nodes = NULL;
+    queue->slabs = NULL;
+    queue->ring = NULL;
+    queue->ring_capacity = 0;
+    queue->ring_head = 0;
+    queue->ring_tail = 0;
+    queue->pid_index = NULL;
+    queue->stats = NULL;
 
     return queue;
 }
@@ -39,159 +374,302 @@ void destroy_queue(Queue *queue) {
         return;
     }
 
-    // Free all nodes in the queue
-    QueueNode *current = queue->head;
-    while (current != NULL) {
-        QueueNode *next = current->next;
-        free(current);
-        current = next;
-    }
-
+    clear_queue(queue);
+    free(queue->heap);
+    free(queue->ring);
+    destroy_pid_index(queue->pid_index);
+    free(queue->stats);
     free(queue);
 }
 
-// Clear queue - remove all nodes but don't destroy the queue itself
+// Clear queue - remove all nodes but don't destroy the queue itself.
+// Every pooled node lives in one of the queue's slabs, so dropping the slabs
+// frees them all; caller-owned nodes are only marked as unlinked.
 void clear_queue(Queue *queue) {
     if (queue == NULL) {
         return;
     }
 
-    QueueNode *current = queue->head;
-    while (current != NULL) {
-        QueueNode *next = current->next;
-        free(current);
-        current = next;
+    if (is_heap_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            queue->heap[i]->linked = 0;
+        }
+    } else if (is_ring_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            QueueRingEntry *entry = ring_entry(queue, i);
+            if (entry->node != NULL) {
+                entry->node->linked = 0;
+            }
+        }
+        queue->ring_head = 0;
+        queue->ring_tail = 0;
+    } else {
+        for (QueueNode *node = queue->head; node != NULL; node = node->next) {
+            node->linked = 0;
+        }
     }
 
+    QueueNodeSlab *slab = queue->slabs;
+    while (slab != NULL) {
+        QueueNodeSlab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    clear_pid_index(queue->pid_index);
+    queue->slabs = NULL;
+    queue->free_nodes = NULL;
     queue->head = NULL;
     queue->tail = NULL;
     queue->size = 0;
 }
 
-// Enqueue a job based on queue type
-void enqueue(Queue *queue, Job *job, int remaining_time) {
-    if (queue == NULL || job == NULL) {
-        return;
+// Link node into the list directly after prev (prev == NULL inserts at the head)
+static void list_insert_after(Queue *queue, QueueNode *prev, QueueNode *node) {
+    QueueNode *next = (prev == NULL) ? queue->head : prev->next;
+
+    node->prev = prev;
+    node->next = next;
+    if (prev == NULL) {
+        queue->head = node;
+    } else {
+        prev->next = node;
     }
+    if (next == NULL) {
+        queue->tail = node;  // Update tail if inserted at end
+    } else {
+        next->prev = node;
+    }
+}
 
-    QueueNode *node = create_node(job, remaining_time);
-    if (node == NULL) {
-        return;
+// Unlink node from the list in O(1) using its prev/next links
+static void list_unlink(Queue *queue, QueueNode *node) {
+    if (node->prev == NULL) {
+        queue->head = node->next;
+    } else {
+        node->prev->next = node->next;
     }
+    if (node->next == NULL) {
+        queue->tail = node->prev;
+    } else {
+        node->next->prev = node->prev;
+    }
+    node->next = NULL;
+    node->prev = NULL;
+}
 
-    // Empty queue case
-    if (queue->head == NULL) {
-        queue->head = node;
-        queue->tail = node;
-        queue->size = 1;
-        return;
+// List ordering for QUEUE_SJF/QUEUE_PRIORITY: does a belong in front of b?
+// Equal keys keep insertion order, so a node goes after its equals.
+static int list_node_before(const Queue *queue, const QueueNode *a, const QueueNode *b) {
+    if (queue->type == QUEUE_SJF) {
+        return a->remaining_time < b->remaining_time ||
+               (a->remaining_time == b->remaining_time && a->job->PID < b->job->PID);
     }
+    if (queue->type == QUEUE_PRIORITY) {
+        return a->job->priority < b->job->priority ||
+               (a->job->priority == b->job->priority && a->job->PID < b->job->PID);
+    }
+    return 0;
+}
+
+// Insert an initialized node according to the queue type.
+// Returns 0 on success; on failure a pooled node has been released.
+static int link_node(Queue *queue, QueueNode *node) {
+    Job *job = node->job;
+    node->seq = queue->next_seq++;
+
+    if (is_heap_queue(queue)) {
+        if (heap_reserve(queue, 1) != 0 || index_add(queue, job) != 0) {
+            release_node(queue, node);
+            return -1;
+        }
+        node->linked = 1;
+        queue->heap[queue->size] = node;
+        queue->size++;
+        stats_insert_steps(queue, heap_sift_up(queue, queue->size - 1));
+        stats_enqueued(queue, 1);
+        return 0;
+    }
+
+    QueueNode *current = queue->head;
+    QueueNode *prev = NULL;
+    int steps = 0;
 
     switch (queue->type) {
         case QUEUE_FIFO:
             // Add to end of queue (FIFO)
-            queue->tail->next = node;
-            queue->tail = node;
-            queue->size++;
+            prev = queue->tail;
             break;
 
         case QUEUE_SJF:
             // Insert based on remaining time (shortest first)
             // If tie, use PID (lower PID first)
-            {
-                QueueNode *current = queue->head;
-                QueueNode *prev = NULL;
-
-                // Find insertion point
-                while (current != NULL) {
-                    if (node->remaining_time < current->remaining_time ||
-                        (node->remaining_time == current->remaining_time &&
-                         job->PID < current->job->PID)) {
-                        break;
-                    }
-                    prev = current;
-                    current = current->next;
-                }
-
-                // Insert at beginning
-                if (prev == NULL) {
-                    node->next = queue->head;
-                    queue->head = node;
-                } else {
-                    // Insert in middle or end
-                    prev->next = node;
-                    node->next = current;
-                    if (current == NULL) {
-                        queue->tail = node;  // Update tail if inserted at end
-                    }
+            while (current != NULL) {
+                if (node->remaining_time < current->remaining_time ||
+                    (node->remaining_time == current->remaining_time &&
+                     job->PID < current->job->PID)) {
+                    break;
                 }
-                queue->size++;
+                prev = current;
+                current = current->next;
+                steps++;
             }
             break;
 
         case QUEUE_PRIORITY:
             // Insert based on priority (lower number = higher priority)
             // If tie, use PID (lower PID first)
-            {
-                QueueNode *current = queue->head;
-                QueueNode *prev = NULL;
-
-                // Find insertion point
-                while (current != NULL) {
-                    if (job->priority < current->job->priority ||
-                        (job->priority == current->job->priority &&
-                         job->PID < current->job->PID)) {
-                        break;
-                    }
-                    prev = current;
-                    current = current->next;
+            while (current != NULL) {
+                if (job->priority < current->job->priority ||
+                    (job->priority == current->job->priority &&
+                     job->PID < current->job->PID)) {
+                    break;
                 }
-
-                // Insert at beginning
-                if (prev == NULL) {
-                    node->next = queue->head;
-                    queue->head = node;
-                } else {
-                    // Insert in middle or end
-                    prev->next = node;
-                    node->next = current;
-                    if (current == NULL) {
-                        queue->tail = node;  // Update tail if inserted at end
-                    }
-                }
-                queue->size++;
+                prev = current;
+                current = current->next;
+                steps++;
             }
             break;
+
+        default:
+            release_node(queue, node);
+            return -1;
+    }
+
+    if (index_add(queue, job) != 0) {
+        release_node(queue, node);
+        return -1;
+    }
+    node->linked = 1;
+    list_insert_after(queue, prev, node);
+    queue->size++;
+    stats_insert_steps(queue, steps);
+    stats_enqueued(queue, 1);
+    return 0;
+}
+
+// Remove the first node from the queue and return it
+static QueueNode* unlink_front(Queue *queue) {
+    QueueNode *node;
+    if (is_heap_queue(queue)) {
+        node = heap_remove_at(queue, 0);
+    } else {
+        node = queue->head;
+        list_unlink(queue, node);
+        queue->size--;
+    }
+    node->linked = 0;
+    index_drop(queue, node->job);
+    stats_dequeued(queue, 1);
+    return node;
+}
+
+// Enqueue a job based on queue type. Returns 0 on success, -1 on bad
+// arguments or out of memory. If handle is not NULL it receives a node for
+// remove_node()/reposition_node() that stays valid until the job leaves the
+// queue; ring slots move, so a ring queue sets it to NULL.
+int enqueue(Queue *queue, Job *job, SimTime remaining_time, QueueNode **handle) {
+    if (handle != NULL) {
+        *handle = NULL;
+    }
+    if (queue == NULL || job == NULL) {
+        return -1;
+    }
+
+    if (is_ring_queue(queue)) {
+        return ring_push(queue, job, remaining_time, NULL);
+    }
+
+    QueueNode *node = create_node(queue, job, remaining_time);
+    if (node == NULL) {
+        return -1;
+    }
+    if (link_node(queue, node) != 0) {
+        return -1;
+    }
+    if (handle != NULL) {
+        *handle = node;
     }
+    return 0;
+}
+
+// Enqueue using a caller-owned node (e.g. embedded in a scheduler context).
+// Returns 0 on success, -1 on bad arguments, an already linked node or out of memory.
+int enqueue_node(Queue *queue, QueueNode *node, Job *job, SimTime remaining_time) {
+    if (queue == NULL || node == NULL || job == NULL || node->linked) {
+        return -1;
+    }
+
+    node->job = job;
+    node->remaining_time = remaining_time;
+    node->next = NULL;
+    node->prev = NULL;
+    node->heap_index = -1;
+    node->pooled = 0;
+    if (is_ring_queue(queue)) {
+        return ring_push(queue, job, remaining_time, node);
+    }
+    return link_node(queue, node);
 }
 
 // Dequeue (remove and return first job)
 Job* dequeue(Queue *queue) {
-    if (queue == NULL || queue->head == NULL) {
+    if (queue == NULL || queue->size == 0) {
         return NULL;
     }
 
-    QueueNode *node = queue->head;
+    if (is_ring_queue(queue)) {
+        return ring_pop(queue).job;
+    }
+
+    QueueNode *node = unlink_front(queue);
     Job *job = node->job;
+    release_node(queue, node);
 
-    queue->head = node->next;
+    return job;
+}
 
-    // If queue is now empty, update tail
-    if (queue->head == NULL) {
-        queue->tail = NULL;
+// Dequeue and return the first node itself. Meant for caller-owned nodes:
+// a pooled node goes back to the pool and is only valid until the next enqueue.
+QueueNode* dequeue_node(Queue *queue) {
+    if (queue == NULL || queue->size == 0) {
+        return NULL;
     }
 
-    queue->size--;
-    free(node);
+    if (is_ring_queue(queue)) {
+        return ring_pop(queue).node;
+    }
 
-    return job;
+    QueueNode *node = unlink_front(queue);
+    release_node(queue, node);
+    return node;
+}
+
+// Peek at the first node without removing it
+QueueNode* peek_node(Queue *queue) {
+    if (queue == NULL || queue->size == 0) {
+        return NULL;
+    }
+    if (is_heap_queue(queue)) {
+        return queue->heap[0];
+    }
+    if (is_ring_queue(queue)) {
+        return queue->ring[queue->ring_head].node;
+    }
+    return queue->head;
 }
 
 // Peek at first job without removing
 Job* peek(Queue *queue) {
-    if (queue == NULL || queue->head == NULL) {
+    if (queue == NULL || queue->size == 0) {
         return NULL;
     }
+    if (is_heap_queue(queue)) {
+        return queue->heap[0]->job;
+    }
+    if (is_ring_queue(queue)) {
+        return queue->ring[queue->ring_head].job;
+    }
     return queue->head->job;
 }
 
@@ -200,7 +678,7 @@ int is_empty(Queue *queue) {
     if (queue == NULL) {
         return 1;  // Treat NULL queue as empty
     }
-    return queue->head == NULL;
+    return queue->size == 0;
 }
 
 // Get queue size
@@ -211,42 +689,465 @@ int queue_size(Queue *queue) {
     return queue->size;
 }
 
+// Call visit on every job in the queue
+void queue_for_each(Queue *queue, void (*visit)(Job *job)) {
+    if (queue == NULL || visit == NULL) {
+        return;
+    }
+
+    if (is_ring_queue(queue)) {
+        // Walk the (at most two) contiguous runs of the ring
+        int first_run = queue->ring_capacity - queue->ring_head;
+        if (first_run > queue->size) {
+            first_run = queue->size;
+        }
+        for (int i = 0; i < first_run; i++) {
+            visit(queue->ring[queue->ring_head + i].job);
+        }
+        for (int i = 0; i < queue->size - first_run; i++) {
+            visit(queue->ring[i].job);
+        }
+    } else if (is_heap_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            visit(queue->heap[i]->job);
+        }
+    } else {
+        for (QueueNode *node = queue->head; node != NULL; node = node->next) {
+            visit(node->job);
+        }
+    }
+}
+
+// Heap batch insert: append everything, then either sift each new node up
+// or rebuild bottom-up (Floyd) when the batch is at least as big as the heap.
+// The caller has reserved heap and PID index space for the batch.
+static void heap_link_batch(Queue *queue, QueueNode **nodes, int count) {
+    int old_size = queue->size;
+    int steps = 0;
+    for (int i = 0; i < count; i++) {
+        QueueNode *node = nodes[i];
+        node->seq = queue->next_seq++;
+        node->linked = 1;
+        node->heap_index = queue->size;
+        queue->heap[queue->size++] = node;
+        index_add(queue, node->job);
+    }
+
+    if (count >= old_size) {
+        for (int i = queue->size / 2 - 1; i >= 0; i--) {
+            steps += heap_sift_down(queue, i);
+        }
+    } else {
+        for (int i = old_size; i < queue->size; i++) {
+            steps += heap_sift_up(queue, i);
+        }
+    }
+    stats_insert_steps(queue, steps);
+    stats_enqueued(queue, count);
+}
+
+// Enqueue a batch of caller-owned nodes whose job and remaining_time are
+// already filled in. The result is the same as enqueue_node() in array order,
+// but heaps and rings reserve space once and heaps are built in O(n + count).
+void enqueue_nodes(Queue *queue, QueueNode **nodes, int count) {
+    if (queue == NULL || nodes == NULL || count <= 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        nodes[i]->next = NULL;
+        nodes[i]->prev = NULL;
+        nodes[i]->heap_index = -1;
+        nodes[i]->pooled = 0;
+    }
+
+    if (index_reserve(queue, count) != 0) {
+        return;
+    }
+    if (is_heap_queue(queue) && heap_reserve(queue, count) == 0) {
+        heap_link_batch(queue, nodes, count);
+        return;
+    }
+    if (is_ring_queue(queue) && ring_reserve(queue, count) != 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (is_ring_queue(queue)) {
+            ring_push(queue, nodes[i]->job, nodes[i]->remaining_time, nodes[i]);
+        } else {
+            link_node(queue, nodes[i]);
+        }
+    }
+}
+
+// Enqueue a batch of jobs from the queue's own pool (same order rules as enqueue_nodes)
+void enqueue_batch(Queue *queue, Job **jobs, const SimTime *remaining_times, int count) {
+    if (queue == NULL || jobs == NULL || remaining_times == NULL || count <= 0) {
+        return;
+    }
+    if (index_reserve(queue, count) != 0) {
+        return;
+    }
+
+    if (is_ring_queue(queue)) {
+        if (ring_reserve(queue, count) != 0) {
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            ring_push(queue, jobs[i], remaining_times[i], NULL);
+        }
+        return;
+    }
+
+    if (is_heap_queue(queue)) {
+        if (heap_reserve(queue, count) != 0) {
+            return;
+        }
+        // Build the nodes directly in the free heap slots, then link them
+        QueueNode **batch = queue->heap + queue->size;
+        int built = 0;
+        for (int i = 0; i < count; i++) {
+            QueueNode *node = create_node(queue, jobs[i], remaining_times[i]);
+            if (node != NULL) {
+                batch[built++] = node;
+            }
+        }
+        heap_link_batch(queue, batch, built);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        enqueue(queue, jobs[i], remaining_times[i], NULL);
+    }
+}
+
+// Hand src's node pool to dst (used when every pooled node moves to dst)
+static void adopt_node_pool(Queue *dst, Queue *src) {
+    if (src->slabs != NULL) {
+        QueueNodeSlab *last = src->slabs;
+        while (last->next != NULL) {
+            last = last->next;
+        }
+        last->next = dst->slabs;
+        dst->slabs = src->slabs;
+    }
+    if (src->free_nodes != NULL) {
+        QueueNode *last = src->free_nodes;
+        while (last->next != NULL) {
+            last = last->next;
+        }
+        last->next = dst->free_nodes;
+        dst->free_nodes = src->free_nodes;
+    }
+    src->slabs = NULL;
+    src->free_nodes = NULL;
+}
+
+// Move the front job of src to dst, keeping caller-owned nodes attached
+static void move_front(Queue *dst, Queue *src) {
+    QueueNode *node = peek_node(src);
+    if (node != NULL && !node->pooled) {
+        dequeue_node(src);
+        enqueue_node(dst, node, node->job, node->remaining_time);
+        return;
+    }
+
+    SimTime remaining_time = is_ring_queue(src) ? src->ring[src->ring_head].remaining_time : node->remaining_time;
+    enqueue(dst, dequeue(src), remaining_time, NULL);
+}
+
+// Append src's jobs to the ring dst as whole runs: src's ring holds at most
+// two contiguous runs and each can wrap once at dst's end, so this is at
+// most four memcpy calls. The caller has reserved room for them in dst.
+static void ring_append_ring(Queue *dst, Queue *src) {
+    int moved = 0;
+    while (moved < src->size) {
+        int from = (src->ring_head + moved) & (src->ring_capacity - 1);
+        int to = dst->ring_tail;
+        int run = src->size - moved;
+        if (run > src->ring_capacity - from) {
+            run = src->ring_capacity - from;
+        }
+        if (run > dst->ring_capacity - to) {
+            run = dst->ring_capacity - to;
+        }
+        memcpy(&dst->ring[to], &src->ring[from], (size_t)run * sizeof(QueueRingEntry));
+        dst->ring_tail = (to + run) & (dst->ring_capacity - 1);
+        moved += run;
+    }
+    dst->size += moved;
+}
+
+// Move every job of src to dst, leaving src empty. Jobs keep their order
+// when dst is a FIFO. List FIFO -> list FIFO relinks in O(1) (plus a walk
+// over src's slab and free lists when src owns pooled nodes); ring -> empty
+// ring swaps buffers in O(1) and ring -> ring copies the entries with
+// memcpy, a few bytes per job in at most four runs. Other combinations move
+// jobs one by one. A PID index on either queue costs O(1) per moved job.
+void queue_splice(Queue *dst, Queue *src) {
+    if (dst == NULL || src == NULL || dst == src || src->size == 0) {
+        return;
+    }
+    if (index_reserve(dst, src->size) != 0) {
+        return;  // Nothing moved
+    }
+
+    if (dst->type == QUEUE_FIFO && src->type == QUEUE_FIFO) {
+        if (src->pid_index != NULL || dst->pid_index != NULL) {
+            for (QueueNode *node = src->head; node != NULL; node = node->next) {
+                index_drop(src, node->job);
+                index_add(dst, node->job);
+            }
+        }
+        if (dst->tail == NULL) {
+            dst->head = src->head;
+        } else {
+            dst->tail->next = src->head;
+            src->head->prev = dst->tail;
+        }
+        dst->tail = src->tail;
+        dst->size += src->size;
+        adopt_node_pool(dst, src);
+
+        int moved = src->size;
+        src->head = NULL;
+        src->tail = NULL;
+        src->size = 0;
+        stats_enqueued(dst, moved);
+        stats_dequeued(src, moved);
+        return;
+    }
+
+    if (is_ring_queue(dst) && is_ring_queue(src) && dst->size == 0) {
+        QueueRingEntry *ring = dst->ring;
+        int capacity = dst->ring_capacity;
+
+        dst->ring = src->ring;
+        dst->ring_capacity = src->ring_capacity;
+        dst->ring_head = src->ring_head;
+        dst->ring_tail = src->ring_tail;
+        dst->size = src->size;
+        if (src->pid_index != NULL || dst->pid_index != NULL) {
+            for (int i = 0; i < dst->size; i++) {
+                index_drop(src, ring_entry(dst, i)->job);
+                index_add(dst, ring_entry(dst, i)->job);
+            }
+        }
+
+        src->ring = ring;
+        src->ring_capacity = capacity;
+        src->ring_head = 0;
+        src->ring_tail = 0;
+        src->size = 0;
+        stats_enqueued(dst, dst->size);
+        stats_dequeued(src, dst->size);
+        return;
+    }
+
+    if (is_ring_queue(dst) && is_ring_queue(src)) {
+        if (ring_reserve(dst, src->size) != 0) {
+            return;
+        }
+        if (src->pid_index != NULL || dst->pid_index != NULL) {
+            for (int i = 0; i < src->size; i++) {
+                index_drop(src, ring_entry(src, i)->job);
+                index_add(dst, ring_entry(src, i)->job);
+            }
+        }
+        ring_append_ring(dst, src);
+
+        int moved = src->size;
+        src->ring_head = 0;
+        src->ring_tail = 0;
+        src->size = 0;
+        stats_enqueued(dst, moved);
+        stats_dequeued(src, moved);
+        return;
+    }
+
+    if (is_ring_queue(dst) && ring_reserve(dst, src->size) != 0) {
+        return;
+    }
+    while (src->size > 0) {
+        move_front(dst, src);
+    }
+}
+
+static void pid_sift_down(QueueNode **nodes, int root, int count) {
+    QueueNode *node = nodes[root];
+    while (1) {
+        int child = 2 * root + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && nodes[child + 1]->job->PID > nodes[child]->job->PID) {
+            child++;
+        }
+        if (nodes[child]->job->PID <= node->job->PID) {
+            break;
+        }
+        nodes[root] = nodes[child];
+        root = child;
+    }
+    nodes[root] = node;
+}
+
+// Sort nodes by ascending PID in place (heapsort), so simultaneous I/O
+// completions can be ordered every tick without allocating
+void sort_nodes_by_pid(QueueNode **nodes, int count) {
+    if (nodes == NULL || count < 2) {
+        return;
+    }
+    for (int i = count / 2 - 1; i >= 0; i--) {
+        pid_sift_down(nodes, i, count);
+    }
+    for (int end = count - 1; end > 0; end--) {
+        QueueNode *top = nodes[0];
+        nodes[0] = nodes[end];
+        nodes[end] = top;
+        pid_sift_down(nodes, 0, end);
+    }
+}
+
+// Remove a node (handle) from the queue: O(1) for lists, O(log n) for heaps
+void remove_node(Queue *queue, QueueNode *node) {
+    if (queue == NULL || node == NULL || !node->linked) {
+        return;
+    }
+
+    if (is_ring_queue(queue)) {
+        int index = ring_find_node(queue, node);
+        if (index >= 0) {
+            ring_remove_at(queue, index);
+        }
+        return;
+    }
+
+    if (is_heap_queue(queue)) {
+        heap_remove_at(queue, node->heap_index);
+    } else {
+        list_unlink(queue, node);
+        queue->size--;
+    }
+    node->linked = 0;
+    index_drop(queue, node->job);
+    release_node(queue, node);
+    stats_removed(queue);
+}
+
+// Change a queued node's remaining time and move it to its new place.
+// O(log n) for heaps; sorted lists walk from the node's old position.
+void reposition_node(Queue *queue, QueueNode *node, SimTime new_remaining_time) {
+    if (queue == NULL || node == NULL || !node->linked) {
+        return;
+    }
+
+    node->remaining_time = new_remaining_time;
+    node->seq = queue->next_seq++;  // Same tie-break as a remove + enqueue
+
+    if (is_ring_queue(queue)) {
+        int index = ring_find_node(queue, node);
+        if (index >= 0) {
+            ring_entry(queue, index)->remaining_time = new_remaining_time;
+        }
+        return;
+    }
+
+    if (is_heap_queue(queue)) {
+        int steps = heap_sift_down(queue, node->heap_index);
+        steps += heap_sift_up(queue, node->heap_index);
+        stats_insert_steps(queue, steps);
+        return;
+    }
+    if (queue->type != QUEUE_SJF) {
+        return;  // Order does not depend on remaining time
+    }
+
+    QueueNode *prev = node->prev;
+    QueueNode *next = node->next;
+    list_unlink(queue, node);
+
+    // Decrease-key moves towards the head, increase-key towards the tail
+    int steps = 0;
+    while (prev != NULL && list_node_before(queue, node, prev)) {
+        next = prev;
+        prev = prev->prev;
+        steps++;
+    }
+    while (next != NULL && !list_node_before(queue, node, next)) {
+        prev = next;
+        next = next->next;
+        steps++;
+    }
+    list_insert_after(queue, prev, node);
+    stats_insert_steps(queue, steps);
+}
+
 // Remove a specific job from queue
 void remove_job(Queue *queue, Job *job) {
-    if (queue == NULL || job == NULL || queue->head == NULL) {
+    if (queue == NULL || job == NULL || queue->size == 0) {
         return;
     }
 
-    QueueNode *current = queue->head;
-    QueueNode *prev = NULL;
+    if (is_ring_queue(queue)) {
+        int index = ring_find_job(queue, job);
+        if (index >= 0) {
+            ring_remove_at(queue, index);
+        }
+        return;
+    }
 
-    // Search for the job
-    while (current != NULL && current->job != job) {
-        prev = current;
-        current = current->next;
+    // Job not found is a no-op
+    remove_node(queue, find_node(queue, job));
+}
+
+// Index the queue's jobs by PID so find_job_by_pid() becomes O(1).
+// Assumes PIDs within the queue are unique. Returns 0 on success.
+int queue_enable_pid_index(Queue *queue) {
+    if (queue == NULL) {
+        return -1;
+    }
+    if (queue->pid_index != NULL) {
+        return 0;
     }
 
-    // Job not found
-    if (current == NULL) {
-        return;
+    queue->pid_index = create_pid_index(queue->size);
+    if (queue->pid_index == NULL) {
+        return -1;
     }
 
-    // Remove node from list
-    if (prev == NULL) {
-        // Removing head
-        queue->head = current->next;
-        if (queue->head == NULL) {
-            queue->tail = NULL;
+    if (is_ring_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            index_add(queue, ring_entry(queue, i)->job);
+        }
+    } else if (is_heap_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            index_add(queue, queue->heap[i]->job);
         }
     } else {
-        prev->next = current->next;
-        if (current->next == NULL) {
-            queue->tail = prev;  // Update tail if removed last element
+        for (QueueNode *node = queue->head; node != NULL; node = node->next) {
+            index_add(queue, node->job);
         }
     }
+    return 0;
+}
 
-    queue->size--;
-    free(current);
+// Start collecting QueueStats. Returns 0 on success.
+int queue_enable_stats(Queue *queue) {
+    if (queue == NULL) {
+        return -1;
+    }
+    if (queue->stats != NULL) {
+        return 0;
+    }
+
+    queue->stats = (QueueStats*)calloc(1, sizeof(QueueStats));
+    return queue->stats == NULL ? -1 : 0;
+}
+
+const QueueStats* queue_get_stats(const Queue *queue) {
+    return queue == NULL ? NULL : queue->stats;
 }
 
 // Find job by PID
@@ -255,6 +1156,28 @@ Job* find_job_by_pid(Queue *queue, int pid) {
         return NULL;
     }
 
+    if (queue->pid_index != NULL) {
+        return (Job*)pid_index_find(queue->pid_index, pid);
+    }
+
+    if (is_ring_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            if (ring_entry(queue, i)->job->PID == pid) {
+                return ring_entry(queue, i)->job;
+            }
+        }
+        return NULL;
+    }
+
+    if (is_heap_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            if (queue->heap[i]->job->PID == pid) {
+                return queue->heap[i]->job;
+            }
+        }
+        return NULL;
+    }
+
     QueueNode *current = queue->head;
     while (current != NULL) {
         if (current->job->PID == pid) {
@@ -266,20 +1189,25 @@ Job* find_job_by_pid(Queue *queue, int pid) {
     return NULL;
 }
 
-// Update remaining time for a job in the queue
-void update_remaining_time(Queue *queue, Job *job, int new_remaining_time) {
+// Update remaining time for a job in the queue (and re-sort ordered queues)
+void update_remaining_time(Queue *queue, Job *job, SimTime new_remaining_time) {
     if (queue == NULL || job == NULL) {
         return;
     }
 
-    QueueNode *current = queue->head;
-    while (current != NULL) {
-        if (current->job == job) {
-            current->remaining_time = new_remaining_time;
-            return;
+    if (is_ring_queue(queue)) {
+        int index = ring_find_job(queue, job);
+        if (index >= 0) {
+            QueueRingEntry *entry = ring_entry(queue, index);
+            entry->remaining_time = new_remaining_time;
+            if (entry->node != NULL) {
+                entry->node->remaining_time = new_remaining_time;
+            }
         }
-        current = current->next;
+        return;
     }
+
+    reposition_node(queue, find_node(queue, job), new_remaining_time);
 }
 
 // Print queue contents (for debugging)
@@ -289,17 +1217,35 @@ void print_queue(Queue *queue) {
         return;
     }
 
-    const char *type_str[] = {"FIFO", "SJF", "PRIORITY"};
+    const char *type_str[] = {"FIFO", "SJF", "PRIORITY", "SJF_HEAP", "PRIORITY_HEAP", "FIFO_RING"};
     printf("Queue (size=%d, type=%s): ", queue->size, type_str[queue->type]);
 
-    if (queue->head == NULL) {
+    if (queue->size == 0) {
         printf("EMPTY\n");
         return;
     }
 
+    if (is_ring_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            QueueRingEntry *entry = ring_entry(queue, i);
+            printf("[PID:%d,RT:%lld] ", entry->job->PID, entry->remaining_time);
+        }
+        printf("\n");
+        return;
+    }
+
+    // Heap-backed queues print in heap array order, not dequeue order
+    if (is_heap_queue(queue)) {
+        for (int i = 0; i < queue->size; i++) {
+            printf("[PID:%d,RT:%lld] ", queue->heap[i]->job->PID, queue->heap[i]->remaining_time);
+        }
+        printf("\n");
+        return;
+    }
+
     QueueNode *current = queue->head;
     while (current != NULL) {
-        printf("[PID:%d,RT:%d] ", current->job->PID, current->remaining_time);
+        printf("[PID:%d,RT:%lld] ", current->job->PID, current->remaining_time);
         current = current->next;
     }
     printf("\n");
@@ -0,0 +1,314 @@
+//
+// Multi-Seed Replications
+// Implementation File
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/sysinfo.h>
+
+#include "include/replicate.h"
+
+#define NUM_METRICS 7
+
+static const char *metric_names[NUM_METRICS] = {
+    "Total time", "Jobs", "Shortest completion", "Longest completion",
+    "Avg completion", "Avg ready", "Avg sleep"
+};
+
+static void metric_values(const Global_Info *info, double *out) {
+    out[0] = info->total_simulate_time;
+    out[1] = info->total_number_of_job;
+    out[2] = info->shortest_job_completion_time;
+    out[3] = info->longest_job_completion_time;
+    out[4] = info->average_completion;
+    out[5] = info->average_ready;
+    out[6] = info->average_sleep;
+}
+
+// Two-sided 95% Student t quantile for df degrees of freedom
+static double t_quantile_95(int df) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df <= 30) {
+        return table[df - 1];
+    }
+    // Cornish-Fisher expansion around the normal quantile
+    double z = 1.959964;
+    double z3 = z * z * z;
+    double z5 = z3 * z * z;
+    return z + (z3 + z) / (4.0 * df) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * df * df);
+}
+
+typedef struct {
+    double mean;
+    double half_width;      // 95% CI half-width, 0 for a single run
+    double min;
+    double max;
+} MetricSummary;
+
+// Running totals of one metric over the replications added so far, in seed
+// order (Welford's update for the spread)
+typedef struct {
+    int count;
+    double sum;
+    double mean;
+    double spread;          // Sum of squared deviations from mean
+    double min;
+    double max;
+} MetricTotals;
+
+static void add_replication(MetricTotals *totals, const Global_Info *info) {
+    double values[NUM_METRICS];
+    metric_values(info, values);
+    for (int m = 0; m < NUM_METRICS; m++) {
+        MetricTotals *t = &totals[m];
+        double value = values[m];
+        t->count++;
+        t->sum += value;
+        double delta = value - t->mean;
+        t->mean += delta / t->count;
+        t->spread += delta * (value - t->mean);
+        if (t->count == 1 || value < t->min) t->min = value;
+        if (t->count == 1 || value > t->max) t->max = value;
+    }
+}
+
+static void summarize(const MetricTotals *t, MetricSummary *out) {
+    out->mean = t->sum / t->count;
+    out->min = t->min;
+    out->max = t->max;
+    out->half_width = 0.0;
+    if (t->count > 1) {
+        out->half_width = t_quantile_95(t->count - 1) * sqrt(t->spread / (t->count - 1) / t->count);
+    }
+}
+
+// Whether every interval over the replications added so far is narrow enough
+static int precise_enough(const MetricTotals *totals, double ci_width) {
+    for (int m = 0; m < NUM_METRICS; m++) {
+        MetricSummary summary;
+        summarize(&totals[m], &summary);
+        if (summary.half_width > ci_width * fabs(summary.mean)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+typedef struct {
+    Job **jobs;
+    int n;
+    SchedulerConfig config;
+    atomic_int next;            // Next replication to hand out in this round
+    int limit;                  // End of the current round
+    Global_Info *results;       // One per replication
+    int *failed;
+
+    // Pool threads stay alive across rounds; the main thread takes part too
+    pthread_mutex_t lock;
+    pthread_cond_t round_cond;  // A new round (or stop) was posted
+    pthread_cond_t done_cond;   // The last pool thread finished its round
+    int round;
+    int busy;                   // Pool threads still working on this round
+    int stop;
+} ReplicateShared;
+
+// Runs replications until the round is exhausted
+static void run_claimed(ReplicateShared *shared) {
+    int index;
+    while ((index = atomic_fetch_add(&shared->next, 1)) < shared->limit) {
+        unsigned int seed = (unsigned int)index + 1;
+        shared->failed[index] = simulate_summary(shared->jobs, shared->n, &shared->config, seed, &shared->results[index]) != 0;
+    }
+}
+
+static void *replicate_worker(void *arg) {
+    ReplicateShared *shared = (ReplicateShared*)arg;
+
+    int seen = 0;
+    pthread_mutex_lock(&shared->lock);
+    while (1) {
+        while (shared->round == seen && !shared->stop) {
+            pthread_cond_wait(&shared->round_cond, &shared->lock);
+        }
+        if (shared->stop) {
+            break;
+        }
+        seen = shared->round;
+        pthread_mutex_unlock(&shared->lock);
+
+        run_claimed(shared);
+
+        pthread_mutex_lock(&shared->lock);
+        if (--shared->busy == 0) {
+            pthread_cond_signal(&shared->done_cond);
+        }
+    }
+    pthread_mutex_unlock(&shared->lock);
+    return NULL;
+}
+
+// Runs replications [next, limit) on the main thread and the pool
+static void run_round(ReplicateShared *shared, int pool_size) {
+    pthread_mutex_lock(&shared->lock);
+    shared->busy = pool_size;
+    shared->round++;
+    pthread_cond_broadcast(&shared->round_cond);
+    pthread_mutex_unlock(&shared->lock);
+
+    run_claimed(shared);
+
+    pthread_mutex_lock(&shared->lock);
+    while (shared->busy > 0) {
+        pthread_cond_wait(&shared->done_cond, &shared->lock);
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+static void print_replication_report(const Global_Info *results, int count, const MetricTotals *totals) {
+    SimTime ticks = 0;
+    for (int i = 0; i < count; i++) {
+        ticks += results[i].total_simulate_time;
+    }
+    printf("Simulated ticks: %lld\n", ticks);
+
+    printf("%-19s | %-12s | %-12s | %-12s | %-12s\n", "Metric", "Mean", "95% CI +/-", "Min", "Max");
+    for (int m = 0; m < NUM_METRICS; m++) {
+        MetricSummary summary;
+        summarize(&totals[m], &summary);
+        printf("%-19s | %-12.2f | ", metric_names[m], summary.mean);
+        if (count > 1) {
+            printf("%-12.2f", summary.half_width);
+        } else {
+            printf("%-12s", "-");
+        }
+        printf(" | %-12.2f | %-12.2f\n", summary.min, summary.max);
+    }
+}
+
+int run_replications(Job **jobs, int n, const SchedulerConfig *base, int max_runs, double ci_width, int threads) {
+    if (jobs == NULL || n <= 0 || base == NULL) {
+        fprintf(stderr, "Error: no jobs available for the replications\n");
+        return -1;
+    }
+    if (max_runs <= 0 || max_runs > REPLICATE_MAX_RUNS) {
+        fprintf(stderr, "Error: replications must be between 1 and %d\n", REPLICATE_MAX_RUNS);
+        return -1;
+    }
+
+    ReplicateShared shared;
+    shared.jobs = jobs;
+    shared.n = n;
+    shared.config = *base;
+    // One host thread per run, no streaming
+    shared.config.host_threads = 1;
+    shared.config.submissions = NULL;
+    shared.results = (Global_Info*)calloc(max_runs, sizeof(Global_Info));
+    shared.failed = (int*)calloc(max_runs, sizeof(int));
+    if (shared.results == NULL || shared.failed == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        free(shared.results);
+        free(shared.failed);
+        return -1;
+    }
+
+    if (threads <= 0) {
+        threads = get_nprocs();
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+    if (threads > max_runs) {
+        threads = max_runs;
+    }
+    // The main thread is one of the threads
+    int pool_size = 0;
+    pthread_t *workers = NULL;
+    pthread_mutex_init(&shared.lock, NULL);
+    pthread_cond_init(&shared.round_cond, NULL);
+    pthread_cond_init(&shared.done_cond, NULL);
+    shared.round = 0;
+    shared.busy = 0;
+    shared.stop = 0;
+    shared.limit = 0;
+    atomic_init(&shared.next, 0);
+    if (threads > 1) {
+        workers = (pthread_t*)malloc(sizeof(pthread_t) * (threads - 1));
+    }
+    while (workers != NULL && pool_size < threads - 1 &&
+           pthread_create(&workers[pool_size], NULL, replicate_worker, &shared) == 0) {
+        pool_size++;
+    }
+
+    // Rounds of one replication per thread. After each round the new results
+    // join the running totals in seed order, so the stopping point is the same
+    // for any pool size; a round only runs ahead of it by fewer than threads
+    // replications.
+    MetricTotals totals[NUM_METRICS] = { 0 };
+    int done = 0;
+    int count = 0;
+    int status = 0;
+    while (count == 0 && done < max_runs) {
+        int limit = done + threads;
+        if (ci_width > 0 && limit < REPLICATE_MIN_RUNS) {
+            limit = REPLICATE_MIN_RUNS;
+        }
+        shared.limit = (limit < max_runs) ? limit : max_runs;
+        atomic_store(&shared.next, done);
+        run_round(&shared, pool_size);
+
+        for (int i = done; i < shared.limit; i++) {
+            if (shared.failed[i]) {
+                fprintf(stderr, "Error: replication with seed %d failed\n", i + 1);
+                status = -1;
+            }
+        }
+        if (status != 0) break;
+
+        for (int k = done + 1; k <= shared.limit && count == 0; k++) {
+            add_replication(totals, &shared.results[k - 1]);
+            if (ci_width > 0 && k >= REPLICATE_MIN_RUNS && precise_enough(totals, ci_width)) {
+                count = k;
+            }
+        }
+        done = shared.limit;
+    }
+
+    pthread_mutex_lock(&shared.lock);
+    shared.stop = 1;
+    pthread_cond_broadcast(&shared.round_cond);
+    pthread_mutex_unlock(&shared.lock);
+    for (int i = 0; i < pool_size; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    pthread_cond_destroy(&shared.done_cond);
+    pthread_cond_destroy(&shared.round_cond);
+    pthread_mutex_destroy(&shared.lock);
+
+    if (status == 0) {
+        if (count > 0) {
+            printf("Replications: %d (stopped: every 95%% CI within %.2f%% of its mean)\n", count, ci_width * 100.0);
+        } else {
+            count = done;
+            if (ci_width > 0) {
+                printf("Replications: %d (limit reached before every 95%% CI was within %.2f%% of its mean)\n",
+                       count, ci_width * 100.0);
+            } else {
+                printf("Replications: %d\n", count);
+            }
+        }
+        print_replication_report(shared.results, count, totals);
+    }
+
+    free(shared.results);
+    free(shared.failed);
+    return status;
+}
@@ -1,13 +1,19 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <string.h>
 
 #include "include/scheduler.h"
+#include "include/scheduler_mlfq.h"
 #include "include/clock.h"
 
 /**
  * Helper function: Prints the final statistics report
  * Strictly follows PDF/Image format [cite: 1]
  */
-static void print_statistics(Job** all_jobs, int n, int total_sim_time, const Global_Info* info) {
+static void print_statistics(Job** all_jobs, int n, SimTime total_sim_time, const Global_Info* info) {
     // Print table header
     printf("Job#   | Total time in ready to run state | Total time in sleeping on I/O state | Total time in system\n");
     printf("=======+==================================+=====================================+======================\n");
@@ -16,7 +22,7 @@ static void print_statistics(Job** all_jobs, int n, int total_sim_time, const Gl
     for (int i = 0; i < n; i++) {
         Job* job = all_jobs[i];
         // Format: "pid" + PID number
-        printf("pid%-4d| %-32d | %-35d | %-20d\n",
+        printf("pid%-4d| %-32lld | %-35lld | %-20lld\n",
                job->PID,
                job->info.ready,
                job->info.sleep,
@@ -27,10 +33,10 @@ static void print_statistics(Job** all_jobs, int n, int total_sim_time, const Gl
     printf("=======+==================================+=====================================+======================\n\n");
 
     // Print summary
-    printf("Total simulation run time: %d\n", total_sim_time);
+    printf("Total simulation run time: %lld\n", total_sim_time);
     printf("Total number of jobs: %d\n", info->total_number_of_job);
-    printf("Shortest job completion time: %d\n", info->shortest_job_completion_time);
-    printf("Longest job completion time: %d\n", info->longest_job_completion_time);
+    printf("Shortest job completion time: %lld\n", info->shortest_job_completion_time);
+    printf("Longest job completion time: %lld\n", info->longest_job_completion_time);
 
     // Ensure averages are printed as floats
     printf("Average job completion time: %.2f\n", info->average_completion);
@@ -54,13 +60,10 @@ void init_global_info(Global_Info* info) {
 }
 
 /**
- * The "update" function:
- * Called at simulation end to calculate and print all stats
+ * Fills info with the summary of a finished run, without printing anything
  */
-void calculate_and_print_final_stats(Global_Info* info, Job** all_jobs, int n, int total_sim_time) {
+void calculate_final_stats(Global_Info* info, Job** all_jobs, int n, SimTime total_sim_time) {
     if (info == NULL || all_jobs == NULL || n == 0) {
-        // Print empty report if no jobs
-        print_statistics(all_jobs, n, total_sim_time, info);
         return;
     }
 
@@ -73,7 +76,7 @@ void calculate_and_print_final_stats(Global_Info* info, Job** all_jobs, int n, i
 
     for (int i = 0; i < n; i++) {
         Job* job = all_jobs[i];
-        int time_in_system = job->info.total; // Assumes info.total is "time in system"
+        SimTime time_in_system = job->info.total; // Assumes info.total is "time in system"
 
         total_completion += time_in_system;
         total_ready += job->info.ready;
@@ -90,67 +93,319 @@ void calculate_and_print_final_stats(Global_Info* info, Job** all_jobs, int n, i
     info->average_completion =  (n > 0) ? (total_completion / n) : 0;
     info->average_ready = (n > 0) ? (total_ready / n) : 0;
     info->average_sleep = (n > 0) ? (total_sleep / n) : 0;
+}
+
+/**
+ * The "update" function:
+ * Called at simulation end to calculate and print all stats
+ */
+void calculate_and_print_final_stats(Global_Info* info, Job** all_jobs, int n, SimTime total_sim_time) {
+    calculate_final_stats(info, all_jobs, n, total_sim_time);
 
     // After calculation, call the private print function
     print_statistics(all_jobs, n, total_sim_time, info);
 }
 
+/**
+ * Takes the next job submitted while the simulation runs, or NULL if none is
+ * visible yet. A job whose arrival is already in the past arrives at clock_tick.
+ * With idle set the scheduler has nothing else to do, so this waits until a job
+ * is submitted or the submission queue is closed and drained.
+ */
+Job* take_submitted_job(SubmissionQueue *submissions, SimTime clock_tick, int idle) {
+    if (submissions == NULL) {
+        return NULL;
+    }
+
+    Job *job = take_submission(submissions);
+    while (job == NULL && idle && !submissions_finished(submissions)) {
+        sched_yield();
+        job = take_submission(submissions);
+    }
+
+    if (job != NULL && job->arrival < clock_tick) {
+        job->arrival = clock_tick;
+    }
+    return job;
+}
+
+void enable_queue_stats(const SimContext *sim, Queue *queue) {
+    if (sim != NULL && sim->queue_stats != NULL) {
+        queue_enable_stats(queue);
+    }
+}
+
+/**
+ * Copies a queue's counters into the run's report; call before destroying the queue
+ */
+void collect_queue_stats(SimContext *sim, const char *name, const Queue *queue) {
+    if (sim == NULL || sim->queue_stats == NULL) return;
+
+    QueueStatsReport *report = sim->queue_stats;
+    const QueueStats *stats = queue_get_stats(queue);
+    if (stats == NULL || report->count >= QUEUE_STATS_MAX_QUEUES) return;
+
+    QueueStatsEntry *entry = &report->entries[report->count++];
+    strncpy(entry->name, name, sizeof(entry->name) - 1);
+    entry->name[sizeof(entry->name) - 1] = '\0';
+    entry->type = queue->type;
+    entry->stats = *stats;
+}
+
+void print_queue_stats_report(const QueueStatsReport *report) {
+    if (report == NULL || report->count == 0) return;
+
+    const char *type_str[] = {"FIFO", "SJF", "PRIORITY", "SJF_HEAP", "PRIORITY_HEAP", "FIFO_RING"};
+
+    printf("\nQueue statistics:\n");
+    printf("%-10s | %-13s | %-10s | %-10s | %-8s | %-12s | %-12s | %-9s | %-9s\n",
+           "Queue", "Type", "Enqueues", "Dequeues", "Removals", "Insert steps", "Remove steps", "Max depth", "Avg depth");
+    for (int i = 0; i < report->count; i++) {
+        const QueueStatsEntry *entry = &report->entries[i];
+        const QueueStats *stats = &entry->stats;
+        double avg_depth = stats->depth_samples > 0 ? (double)stats->depth_sum / stats->depth_samples : 0.0;
+        printf("%-10s | %-13s | %-10lu | %-10lu | %-8lu | %-12lu | %-12lu | %-9d | %-9.2f\n",
+               entry->name, type_str[entry->type], stats->enqueues, stats->dequeues, stats->removals,
+               stats->insert_steps, stats->remove_steps, stats->max_depth, avg_depth);
+    }
+}
+
+void print_cpu_report(const CpuReport *report) {
+    if (report == NULL || report->cpus == 0 || report->per_cpu == NULL) return;
+
+    printf("\nCPU utilization:\n");
+    printf("%-6s | %-10s | %-11s | %-10s | %-6s\n", "CPU", "Busy ticks", "Utilization", "Dispatches", "Steals");
+    for (int i = 0; i < report->cpus; i++) {
+        const CpuStats *stats = &report->per_cpu[i];
+        double utilization = report->total_time > 0 ? 100.0 * stats->busy_ticks / report->total_time : 0.0;
+        char percent[16];
+        snprintf(percent, sizeof(percent), "%.2f%%", utilization);
+        printf("cpu%-3d | %-10lld | %-11s | %-10d | %-6d\n",
+               i, stats->busy_ticks, percent, stats->dispatches, stats->steals);
+    }
+}
+
+typedef void (*TickScheduler)(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config);
+
+// Run a policy with the engine chosen in config
+static void run_policy(SimContext *sim, TickScheduler tick_scheduler, Job **jobs, int n,
+                       const SchedulerConfig *config, CpuReport *cpu_report) {
+    if (config->engine == SCHED_ENGINE_EVENT) {
+        schedule_events(sim, jobs, n, config);
+    } else if (config->cpus > 1) {
+        schedule_multicore(sim, jobs, n, config, cpu_report);
+    } else {
+        tick_scheduler(sim, jobs, n, config);
+    }
+}
+
 static void report_invalid_policy(SchedulerPolicy policy) {
     fprintf(stderr, "Error: unsupported scheduler policy (%d)\n", policy);
 }
 
-void schedule(Job **jobs, int n, SchedulerPolicy policy, int time_quantum) {
+/**
+ * Initializes a SchedulerConfig with the defaults (SJF, no submissions)
+ */
+void init_scheduler_config(SchedulerConfig *config) {
+    if (config == NULL) return;
+
+    config->policy = SCHED_POLICY_SJF;
+    config->engine = SCHED_ENGINE_TICK;
+    config->time_quantum = 0;
+    config->mlfq_time_slice[0] = MLFQ_TIME_SLICE_Q0;
+    config->mlfq_time_slice[1] = MLFQ_TIME_SLICE_Q1;
+    config->mlfq_time_slice[2] = MLFQ_TIME_SLICE_Q2;
+    config->mlfq_boost_interval = MLFQ_BOOST_INTERVAL;
+    config->fast_forward = 0;
+    config->cpus = 1;
+    config->host_threads = 1;
+    config->rng = SIM_RNG_COMPAT;
+    config->horizon = 0;
+    config->submissions = NULL;
+}
+
+/**
+ * Last tick a run simulates: config->horizon, or SIM_TIME_MAX without one
+ */
+SimTime horizon_limit(const SchedulerConfig *config) {
+    return (config->horizon > 0) ? config->horizon : SIM_TIME_MAX;
+}
 
-    if (jobs == NULL || n <= 0) {
+/**
+ * Whether the clock has passed config->horizon, checked once per tick after
+ * the clock advances. Jobs still in the system are cut short, so this is
+ * reported when it happens.
+ */
+int past_horizon(const SchedulerConfig *config, SimTime clock) {
+    if (clock <= horizon_limit(config)) {
+        return 0;
+    }
+    fprintf(stderr, "Warning: simulation stopped at the horizon (tick %lld); unfinished jobs are cut short\n",
+            config->horizon);
+    return 1;
+}
+
+/**
+ * Validates config and runs one simulation, leaving the results in the jobs
+ * and sim's clock. Prints nothing but errors. Returns 0 on success, -1 if the
+ * configuration was rejected.
+ */
+int simulate(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config, CpuReport *cpu_report) {
+
+    if (sim == NULL || config == NULL) {
+        fprintf(stderr, "Error: missing simulation context or scheduler configuration\n");
+        return -1;
+    }
+
+    // With a submission queue the run may start empty and receive jobs later
+    if (n < 0 || (n > 0 && jobs == NULL) || (n == 0 && config->submissions == NULL)) {
         fprintf(stderr, "Error: no jobs available for scheduling\n");
-        return;
+        return -1;
+    }
+
+    if (config->engine == SCHED_ENGINE_EVENT && config->submissions != NULL) {
+        fprintf(stderr, "Error: the event engine does not accept streamed submissions\n");
+        return -1;
+    }
+
+    if (config->cpus > 1 && (config->engine == SCHED_ENGINE_EVENT || config->submissions != NULL)) {
+        fprintf(stderr, "Error: multiple CPUs require the tick engine without streamed submissions\n");
+        return -1;
     }
 
+    if (config->horizon < 0 || (config->horizon > 0 && config->engine == SCHED_ENGINE_EVENT)) {
+        fprintf(stderr, "Error: a horizon must be positive and requires the tick engine\n");
+        return -1;
+    }
+
+    if (config->policy == SCHED_POLICY_MLFQ) {
+        int valid = config->mlfq_boost_interval > 0;
+        for (int level = 0; level < MLFQ_NUM_QUEUES; level++) {
+            valid = valid && config->mlfq_time_slice[level] > 0;
+        }
+        if (!valid) {
+            fprintf(stderr, "Error: MLFQ time slices and boost interval must be positive\n");
+            return -1;
+        }
+    }
+
+    SchedulerPolicy policy = config->policy;
+    int time_quantum = config->time_quantum;
+
 #if defined(BUILD_SJF_ONLY)
     if (policy != SCHED_POLICY_SJF) {
         fprintf(stderr, "Error: this binary only supports SJF policy.\n");
-        return;
+        return -1;
     }
-    schedule_sjf(jobs, n);
+    run_policy(sim, schedule_sjf, jobs, n, config, cpu_report);
 #elif defined(BUILD_RR_ONLY)
     if (policy != SCHED_POLICY_RR) {
         fprintf(stderr, "Error: this binary only supports RR policy.\n");
-        return;
+        return -1;
     }
     if (time_quantum <= 0) {
         fprintf(stderr, "Error: round-robin requires a positive time quantum\n");
-        return;
+        return -1;
     }
-    schedule_rr(jobs, n, time_quantum);
+    run_policy(sim, schedule_rr, jobs, n, config, cpu_report);
 #elif defined(BUILD_MLFQ_ONLY)
     if (policy != SCHED_POLICY_MLFQ) {
         fprintf(stderr, "Error: this binary only supports MLFQ policy.\n");
-        return;
+        return -1;
     }
-    schedule_mlfq(jobs, n);
+    run_policy(sim, schedule_mlfq, jobs, n, config, cpu_report);
 #else
     switch (policy) {
         case SCHED_POLICY_SJF:
-            schedule_sjf(jobs, n);
+            run_policy(sim, schedule_sjf, jobs, n, config, cpu_report);
             break;
         case SCHED_POLICY_RR:
             if (time_quantum <= 0) {
                 fprintf(stderr, "Error: round-robin requires a positive time quantum\n");
-                return;
+                return -1;
             }
-            schedule_rr(jobs, n, time_quantum);
+            run_policy(sim, schedule_rr, jobs, n, config, cpu_report);
             break;
         case SCHED_POLICY_MLFQ:
-            schedule_mlfq(jobs, n);
+            run_policy(sim, schedule_mlfq, jobs, n, config, cpu_report);
             break;
         default:
             report_invalid_policy(policy);
-            break;
+            return -1;
     }
 #endif
+    return 0;
+}
+
+/**
+ * Runs config on private copies of jobs (the originals are only read) with a
+ * fresh context seeded with seed, and fills info with the run's summary.
+ * Safe to call from several threads at once. Returns 0 on success.
+ */
+int simulate_summary(Job **jobs, int n, const SchedulerConfig *config, unsigned int seed, Global_Info *info) {
+    init_global_info(info);
+    if (jobs == NULL || n <= 0 || config == NULL || config->submissions != NULL) {
+        return -1;
+    }
+
+    Job *copies = (Job*)malloc(sizeof(Job) * n);
+    Job **table = (Job**)malloc(sizeof(Job*) * n);
+    if (copies == NULL || table == NULL) {
+        free(copies);
+        free(table);
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        copies[i] = *jobs[i];
+        table[i] = &copies[i];
+    }
+
+    SimContext sim;
+    CpuReport cpu_report = { 0 };
+    init_sim_context(&sim, config->rng, seed);
+    int status = simulate(&sim, table, n, config, &cpu_report);
+    if (status == 0) {
+        calculate_final_stats(info, table, n, current_clock(&sim));
+    }
+
+    free(cpu_report.per_cpu);
+    free(copies);
+    free(table);
+    return status;
+}
+
+void schedule(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config) {
+    CpuReport cpu_report = { 0 };
+    if (simulate(sim, jobs, n, config, &cpu_report) != 0) {
+        return;
+    }
+
+    // Jobs taken from the submission queue are reported after the preloaded ones
+    SubmissionQueue *submissions = config->submissions;
+    int submitted = (submissions != NULL) ? submissions->accepted_count : 0;
+    Job **all_jobs = jobs;
+    if (submitted > 0) {
+        all_jobs = (Job**)malloc(sizeof(Job*) * (n + submitted));
+        if (all_jobs == NULL) {
+            fprintf(stderr, "Error: failed to allocate job report\n");
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            all_jobs[i] = jobs[i];
+        }
+        for (int i = 0; i < submitted; i++) {
+            all_jobs[n + i] = submissions->accepted[i];
+        }
+    }
 
     Global_Info info;
     init_global_info(&info);
-    calculate_and_print_final_stats(&info, jobs, n, current_clock());
-}
+    calculate_and_print_final_stats(&info, all_jobs, n + submitted, current_clock(sim));
+    print_queue_stats_report(sim->queue_stats);
+    print_cpu_report(&cpu_report);
+    free(cpu_report.per_cpu);
 
+    if (all_jobs != jobs) {
+        free(all_jobs);
+    }
+}
@@ -0,0 +1,375 @@
+//
+// Discrete-Event Scheduler Engine
+// Implementation File
+//
+// Runs SJF, RR or MLFQ without visiting every tick. The end of the running
+// job's CPU burst, I/O completions, arrivals and MLFQ boosts are events on an
+// EventCalendar and the clock jumps from one event to the next, so the cost
+// depends on the number of scheduling events rather than on simulated time.
+//
+// Instead of drawing IO_request()/IO_complete() once per tick, each CPU burst
+// and each I/O draws its length from the equivalent geometric distribution.
+// Results therefore match the tick engine statistically, not draw for draw,
+// except with SIM_RNG_KEYED: there the length is counted from the same
+// per-(PID, tick) outcomes the tick loops draw, so the output is identical.
+// Ready/sleep/run time is added per state span with the same counting rules
+// as the tick loops (wait()/sleep()/run() once per tick).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "include/scheduler.h"
+#include "include/scheduler_mlfq.h"
+#include "include/event_calendar.h"
+#include "include/arrival_cursor.h"
+#include "include/queue.h"
+#include "include/clock.h"
+#include "include/utils.h"
+
+typedef enum {
+    EVENT_JOB_NEW = 0,
+    EVENT_JOB_READY,
+    EVENT_JOB_RUNNING,
+    EVENT_JOB_IO,
+    EVENT_JOB_DONE
+} EventJobState;
+
+// How the running job's current burst ends
+typedef enum {
+    BURST_COMPLETE,
+    BURST_IO,
+    BURST_SLICE
+} BurstEnd;
+
+typedef struct {
+    Job *job;
+    SimTime remaining_time;     // CPU ticks still needed when the job last left the CPU
+    int level;                  // MLFQ level (0 for SJF/RR)
+    EventJobState state;
+    SimTime since;              // Tick the job entered its current state
+    int io_checks;              // IO_complete() calls the current I/O stands for
+    BurstEnd burst_end;
+    unsigned int generation;    // Bumped when the job leaves the CPU; older events are stale
+    QueueNode link;             // Ready queue link
+} EventJobContext;
+
+typedef struct {
+    SimContext *sim;
+    const SchedulerConfig *config;
+    SchedulerPolicy policy;
+    EventJobContext *contexts;
+    int count;
+    EventCalendar *calendar;
+    ArrivalCursor *arrivals;        // Only the next arrival is on the calendar
+    Queue *ready[MLFQ_NUM_QUEUES];  // SJF and RR only use ready[0]
+    int levels;
+    EventJobContext *running;
+    SimTime dispatched_at;          // Tick the running job was dispatched
+    int in_system;                  // Jobs that arrived and have not completed
+    int completed;
+    SimTime last_completion;
+    long io_order;                  // FIFO order of I/O completions within a tick
+    int failed;
+} EventEngine;
+
+static EventJobContext *context_of(QueueNode *node) {
+    if (node == NULL) {
+        return NULL;
+    }
+    return queue_node_container(node, EventJobContext, link);
+}
+
+static int context_index(const EventEngine *engine, const EventJobContext *ctx) {
+    return (int)(ctx - engine->contexts);
+}
+
+static void add_event(EventEngine *engine, SimTime time, EventType type, long order, EventJobContext *ctx) {
+    Event event;
+    event.time = time;
+    event.type = type;
+    event.order = order;
+    event.target = (ctx != NULL) ? context_index(engine, ctx) : -1;
+    event.generation = (ctx != NULL) ? ctx->generation : 0;
+    if (schedule_event(engine->calendar, event) != 0) {
+        engine->failed = 1;
+    }
+}
+
+// Put the next job in arrival order on the calendar
+static void add_next_arrival(EventEngine *engine) {
+    int i = arrival_cursor_next(engine->arrivals, SIM_TIME_MAX);
+    if (i >= 0) {
+        add_event(engine, engine->contexts[i].job->arrival, EVENT_ARRIVAL, engine->contexts[i].job->PID,
+                  &engine->contexts[i]);
+    }
+}
+
+static SimTime time_slice_of(const EventEngine *engine, const EventJobContext *ctx) {
+    switch (engine->policy) {
+        case SCHED_POLICY_RR:
+            return engine->config->time_quantum;
+        case SCHED_POLICY_MLFQ:
+            return engine->config->mlfq_time_slice[ctx->level];
+        default:
+            return SIM_TIME_MAX;
+    }
+}
+
+static void make_ready(EventEngine *engine, EventJobContext *ctx, SimTime now) {
+    ctx->state = EVENT_JOB_READY;
+    ctx->since = now;
+    enqueue_node(engine->ready[ctx->level], &ctx->link, ctx->job, ctx->remaining_time);
+}
+
+// Plan the running job's burst from now: it runs until it completes, requests
+// I/O or uses up its time slice, whichever comes first (in that priority,
+// matching the order the tick loops check them after run()).
+static void plan_burst(EventEngine *engine, SimTime now) {
+    EventJobContext *ctx = engine->running;
+    SimTime until_io = ticks_until_IO_request(engine->sim, ctx->job->PID, now);
+    SimTime slice = time_slice_of(engine, ctx);
+
+    SimTime burst;
+    if (ctx->remaining_time <= until_io && ctx->remaining_time <= slice) {
+        burst = ctx->remaining_time;
+        ctx->burst_end = BURST_COMPLETE;
+    } else if (until_io <= slice) {
+        burst = until_io;
+        ctx->burst_end = BURST_IO;
+    } else {
+        burst = slice;
+        ctx->burst_end = BURST_SLICE;
+    }
+
+    // RR checks the slice at the next tick, after that tick's arrivals and I/O
+    EventType type = (ctx->burst_end == BURST_SLICE && engine->policy == SCHED_POLICY_RR)
+                     ? EVENT_QUANTUM_EXPIRY : EVENT_BURST_END;
+    add_event(engine, now + burst, type, 0, ctx);
+}
+
+// Account the CPU time of the running job up to now and take it off the CPU
+static EventJobContext *leave_cpu(EventEngine *engine, SimTime now) {
+    EventJobContext *ctx = engine->running;
+    SimTime ran = now - engine->dispatched_at;
+    run_span(ctx->job, ran);
+    ctx->remaining_time -= ran;
+    ctx->generation++;
+    engine->running = NULL;
+    return ctx;
+}
+
+static void dispatch(EventEngine *engine, SimTime now) {
+    for (int level = 0; level < engine->levels; level++) {
+        EventJobContext *ctx = context_of(dequeue_node(engine->ready[level]));
+        if (ctx == NULL) {
+            continue;
+        }
+
+        wait_span(ctx->job, now - ctx->since);
+        ctx->state = EVENT_JOB_RUNNING;
+        ctx->level = level;
+        engine->running = ctx;
+        engine->dispatched_at = now;
+        plan_burst(engine, now);
+        return;
+    }
+}
+
+static void handle_burst_end(EventEngine *engine, EventJobContext *ctx, SimTime now) {
+    leave_cpu(engine, now);
+
+    switch (ctx->burst_end) {
+        case BURST_COMPLETE:
+            ctx->state = EVENT_JOB_DONE;
+            engine->completed++;
+            engine->in_system--;
+            engine->last_completion = now;
+            break;
+
+        case BURST_IO: {
+            // The tick loops call IO_complete() once per tick starting with
+            // the next one; the job is ready again on the tick of the first success.
+            ctx->state = EVENT_JOB_IO;
+            ctx->since = now;
+            ctx->io_checks = ticks_until_IO_complete(engine->sim, ctx->job->PID, now);
+            long order = (engine->policy == SCHED_POLICY_RR) ? ctx->job->PID : engine->io_order++;
+            add_event(engine, now + ctx->io_checks - 1, EVENT_IO_DONE, order, ctx);
+            break;
+        }
+
+        case BURST_SLICE:
+            // MLFQ demotion (RR slices end through EVENT_QUANTUM_EXPIRY)
+            if (engine->policy == SCHED_POLICY_MLFQ && ctx->level < engine->levels - 1) {
+                ctx->level++;
+            }
+            make_ready(engine, ctx, now);
+            break;
+    }
+}
+
+static void handle_io_done(EventEngine *engine, EventJobContext *ctx, SimTime now) {
+    // SJF/RR count sleep on every IO_complete() call; MLFQ only on the ticks
+    // the job is still in I/O after the check
+    int slept = (engine->policy == SCHED_POLICY_MLFQ) ? ctx->io_checks - 1 : ctx->io_checks;
+    sleep_span(ctx->job, slept);
+    make_ready(engine, ctx, now);
+}
+
+static void handle_boost(EventEngine *engine, SimTime now) {
+    for (int level = 1; level < engine->levels; level++) {
+        queue_splice(engine->ready[0], engine->ready[level]);
+    }
+
+    // The running job moves to level 0 and starts a fresh slice
+    EventJobContext *ctx = engine->running;
+    if (ctx != NULL && ctx->level > 0) {
+        leave_cpu(engine, now);
+        ctx->level = 0;
+        engine->running = ctx;
+        engine->dispatched_at = now;
+        plan_burst(engine, now);
+    }
+
+    if (engine->completed >= engine->count) {
+        return;
+    }
+
+    // Boosting an empty system changes nothing, so skip to the first boost
+    // after the next arrival
+    int interval = engine->config->mlfq_boost_interval;
+    SimTime next = now + interval;
+    if (engine->in_system == 0) {
+        SimTime next_arrival = next_event_time(engine->calendar);
+        if (next_arrival >= next) {
+            next = (next_arrival / interval + 1) * interval;
+        }
+    }
+    add_event(engine, next, EVENT_BOOST, 0, NULL);
+}
+
+// Decisions taken once every event of the tick has been handled
+static void decide(EventEngine *engine, SimTime now) {
+    EventJobContext *current = engine->running;
+
+    // SJF preemption: a ready job needs less CPU than the running one has left
+    if (engine->policy == SCHED_POLICY_SJF && current != NULL) {
+        EventJobContext *candidate = context_of(peek_node(engine->ready[0]));
+        SimTime current_remaining = current->remaining_time - (now - engine->dispatched_at);
+        if (candidate != NULL && candidate->remaining_time < current_remaining) {
+            leave_cpu(engine, now);
+            make_ready(engine, current, now);
+        }
+    }
+
+    if (engine->running == NULL) {
+        dispatch(engine, now);
+    }
+}
+
+static void handle_event(EventEngine *engine, const Event *event) {
+    EventJobContext *ctx = (event->target >= 0) ? &engine->contexts[event->target] : NULL;
+
+    switch (event->type) {
+        case EVENT_BURST_END:
+        case EVENT_QUANTUM_EXPIRY:
+            if (ctx->generation != event->generation) {
+                return;  // The job was preempted or boosted since
+            }
+            if (event->type == EVENT_QUANTUM_EXPIRY) {
+                leave_cpu(engine, event->time);
+                make_ready(engine, ctx, event->time);
+            } else {
+                handle_burst_end(engine, ctx, event->time);
+            }
+            break;
+
+        case EVENT_ARRIVAL:
+            ctx->remaining_time = ctx->job->service;
+            ctx->level = 0;
+            engine->in_system++;
+            make_ready(engine, ctx, event->time);
+            add_next_arrival(engine);
+            break;
+
+        case EVENT_IO_DONE:
+            handle_io_done(engine, ctx, event->time);
+            break;
+
+        case EVENT_BOOST:
+            handle_boost(engine, event->time);
+            break;
+    }
+}
+
+void schedule_events(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config) {
+    if (jobs == NULL || n <= 0 || config == NULL) {
+        return;
+    }
+
+    EventEngine engine = { 0 };
+    engine.sim = sim;
+    engine.config = config;
+    engine.policy = config->policy;
+    engine.count = n;
+    engine.levels = (config->policy == SCHED_POLICY_MLFQ) ? MLFQ_NUM_QUEUES : 1;
+
+    engine.contexts = (EventJobContext*)calloc(n, sizeof(EventJobContext));
+    engine.calendar = create_event_calendar(n + 2);
+    engine.arrivals = create_arrival_cursor(jobs, n, n);
+    int ready_ok = 1;
+    for (int level = 0; level < engine.levels; level++) {
+        // MLFQ levels are lists so the boost relinks them instead of copying
+        QueueType type = (engine.policy == SCHED_POLICY_SJF) ? QUEUE_SJF_HEAP :
+                         (engine.policy == SCHED_POLICY_MLFQ) ? QUEUE_FIFO : QUEUE_FIFO_RING;
+        engine.ready[level] = create_queue(type);
+        ready_ok = ready_ok && engine.ready[level] != NULL;
+        enable_queue_stats(sim, engine.ready[level]);
+    }
+
+    if (engine.contexts == NULL || engine.calendar == NULL || engine.arrivals == NULL || !ready_ok) {
+        fprintf(stderr, "Event engine: failed to allocate simulation state\n");
+        engine.failed = 1;
+    } else {
+        init_clock(sim);
+
+        for (int i = 0; i < n; i++) {
+            engine.contexts[i].job = jobs[i];
+            engine.contexts[i].state = EVENT_JOB_NEW;
+        }
+        add_next_arrival(&engine);
+        if (engine.policy == SCHED_POLICY_MLFQ) {
+            add_event(&engine, config->mlfq_boost_interval, EVENT_BOOST, 0, NULL);
+        }
+
+        Event event;
+        while (!engine.failed && next_event(engine.calendar, &event)) {
+            handle_event(&engine, &event);
+            if (next_event_time(engine.calendar) != event.time) {
+                decide(&engine, event.time);
+            }
+        }
+
+        if (engine.failed) {
+            fprintf(stderr, "Event engine: failed to schedule an event\n");
+        }
+        advance_clock_to(sim, engine.last_completion);
+    }
+
+    for (int level = 0; level < engine.levels; level++) {
+        if (engine.ready[level] == NULL) {
+            continue;
+        }
+        char name[16];
+        if (engine.levels > 1) {
+            snprintf(name, sizeof(name), "level %d", level);
+        } else {
+            snprintf(name, sizeof(name), "ready");
+        }
+        collect_queue_stats(sim, name, engine.ready[level]);
+        destroy_queue(engine.ready[level]);
+    }
+    destroy_event_calendar(engine.calendar);
+    destroy_arrival_cursor(engine.arrivals);
+    free(engine.contexts);
+}
@@ -5,9 +5,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h>
 #include "include/scheduler_mlfq.h"
 #include "include/scheduler.h"
+#include "include/arrival_cursor.h"
 #include "include/utils.h"
 #include "include/clock.h"
 
@@ -15,16 +15,16 @@
 static void init_statistics(Statistics *stats) {
     stats->total_jobs = 0;
     stats->total_simulation_time = 0;
-    stats->shortest_job_time = INT_MAX;
+    stats->shortest_job_time = SIM_TIME_MAX;
     stats->longest_job_time = 0;
     stats->total_ready_time = 0;
     stats->total_sleep_time = 0;
 }
 
 // Helper function to update statistics when a job completes
-static void update_statistics(Statistics *stats, Job *job, int completion_time) {
+static void update_statistics(Statistics *stats, Job *job, SimTime completion_time) {
     stats->total_jobs++;
-    int turnaround = completion_time - job->arrival;
+    SimTime turnaround = completion_time - job->arrival;
     if (turnaround < stats->shortest_job_time) {
         stats->shortest_job_time = turnaround;
     }
@@ -59,36 +59,136 @@ static void update_statistics(Statistics *stats, Job *job, int completion_time)
 // }
 
 // Helper function to get time slice for a queue level
-static int get_time_slice(int queue_level) {
-    switch (queue_level) {
-        case 0: return MLFQ_TIME_SLICE_Q0;
-        case 1: return MLFQ_TIME_SLICE_Q1;
-        case 2: return MLFQ_TIME_SLICE_Q2;
-        default: return MLFQ_TIME_SLICE_Q2;
+static int get_time_slice(const SchedulerConfig *config, int queue_level) {
+    if (queue_level < 0) {
+        queue_level = 0;
+    }
+    if (queue_level >= MLFQ_NUM_QUEUES) {
+        queue_level = MLFQ_NUM_QUEUES - 1;
+    }
+    return config->mlfq_time_slice[queue_level];
+}
+
+// Helper function to get the job index of the state embedding a queue node
+static int job_index_of(QueueNode *node, MLFQJobState *job_states) {
+    if (node == NULL) {
+        return -1;
+    }
+    return (int)(queue_node_container(node, MLFQJobState, link) - job_states);
+}
+
+// Rule 5: move every queued job to queue 0, keeping their order.
+// A queued job always has time_slice_used == 0, and its level is set when
+// it is dispatched, so no per-job work is needed for queued jobs.
+static void boost_priorities(Queue **mlfq, MLFQJobState *job_states, int current_job_index) {
+    for (int level = 1; level < MLFQ_NUM_QUEUES; level++) {
+        queue_splice(mlfq[0], mlfq[level]);
+    }
+
+    // If current job is not in queue 0, move it too
+    if (current_job_index >= 0) {
+        if (job_states[current_job_index].current_queue_level > 0) {
+            job_states[current_job_index].current_queue_level = 0;
+            job_states[current_job_index].time_slice_used = 0;
+        }
+    }
+}
+
+// Step 5: run the current job for one tick. It leaves the CPU when it
+// completes, requests I/O or uses up its time slice (and is demoted).
+static void run_current_job(SimContext *sim, Job **current_job, int *current_job_index, int *current_time_slice,
+                            MLFQJobState *job_states, Queue **mlfq, Queue *io_queue, Statistics *stats,
+                            const SchedulerConfig *config) {
+    Job *job = *current_job;
+    MLFQJobState *state = &job_states[*current_job_index];
+
+    run(job);
+    state->time_slice_used++;
+    (*current_time_slice)++;
+
+    // Check if job is complete (check CPU time, not total time)
+    SimTime run_time = job->info.total - job->info.ready - job->info.sleep;
+    if (run_time >= job->service) {
+        // Job completed
+        update_statistics(stats, job, current_clock(sim) + 1);
+        *current_job = NULL;
+        *current_job_index = -1;
+    } else {
+        // Check for I/O request
+        if (IO_request(sim, job->PID)) {
+            // Move to I/O queue (Rule 4: didn't use full slice, keep priority)
+            SimTime remaining = job->service - run_time;
+            state->since = current_clock(sim) + 1;
+            enqueue_node(io_queue, &state->link, job, remaining);
+            *current_job = NULL;
+            *current_job_index = -1;
+        } else if (state->time_slice_used >= get_time_slice(config, state->current_queue_level)) {
+            // Rule 4: Used full time slice, demote to lower queue
+            int current_level = state->current_queue_level;
+            if (current_level < MLFQ_NUM_QUEUES - 1) {
+                state->current_queue_level++;
+            }
+            state->time_slice_used = 0;
+            state->since = current_clock(sim) + 1;
+
+            SimTime remaining = job->service - run_time;
+            enqueue_node(mlfq[state->current_queue_level], &state->link, job, remaining);
+            *current_job = NULL;
+            *current_job_index = -1;
+        }
+    }
+}
+
+static int all_levels_empty(Queue **mlfq) {
+    for (int level = 0; level < MLFQ_NUM_QUEUES; level++) {
+        if (!is_empty(mlfq[level])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Helper function to charge the open span of every job still in a queue when
+// the simulation stops (e.g. at the horizon), emptying the queue
+static void charge_open_spans(SimContext *sim, Queue *queue, MLFQJobState *job_states, void (*charge)(Job *job, SimTime ticks)) {
+    QueueNode *node;
+    while ((node = dequeue_node(queue)) != NULL) {
+        int job_idx = job_index_of(node, job_states);
+        charge(node->job, current_clock(sim) - job_states[job_idx].since);
     }
 }
 
 // Main MLFQ scheduler
-void run_mlfq_scheduler(Job **jobs, int num_jobs) {
-    if (jobs == NULL || num_jobs == 0) {
+void run_mlfq_scheduler(SimContext *sim, Job **jobs, int num_jobs, const SchedulerConfig *config) {
+    SchedulerConfig defaults;
+    if (config == NULL) {
+        init_scheduler_config(&defaults);
+        config = &defaults;
+    }
+    SubmissionQueue *submissions = (config != NULL) ? config->submissions : NULL;
+    if ((jobs == NULL || num_jobs <= 0) && submissions == NULL) {
         printf("No jobs to schedule.\n");
         return;
     }
+    if (num_jobs < 0) {
+        num_jobs = 0;
+    }
 
-    os_srand(1);
-    init_clock();  // Initialize the global clock
-    int next_job_index = 0;  // Index of next job to arrive
+    init_clock(sim);
     int boost_counter = 0;   // Counter for priority boost
 
-    // Create 3 MLFQ queues )
+    // Create 3 MLFQ queues. Lists, not rings: the boost splices them in O(1)
     Queue *mlfq[MLFQ_NUM_QUEUES];
     for (int i = 0; i < MLFQ_NUM_QUEUES; i++) {
         mlfq[i] = create_queue(QUEUE_FIFO);
+        enable_queue_stats(sim, mlfq[i]);
     }
-    Queue *io_queue = create_queue(QUEUE_FIFO);
+    Queue *io_queue = create_queue(QUEUE_FIFO_RING);
+    enable_queue_stats(sim, io_queue);
 
-    // Track MLFQ state for each job
-    MLFQJobState *job_states = (MLFQJobState*)malloc(num_jobs * sizeof(MLFQJobState));
+    // Track MLFQ state for each job, with room reserved for submitted jobs
+    int capacity = num_jobs + submission_capacity(submissions);
+    MLFQJobState *job_states = (MLFQJobState*)calloc(capacity > 0 ? capacity : 1, sizeof(MLFQJobState));
     for (int i = 0; i < num_jobs; i++) {
         job_states[i].current_queue_level = 0;  // Start at highest priority
         job_states[i].time_slice_used = 0;
@@ -104,123 +204,133 @@ void run_mlfq_scheduler(Job **jobs, int num_jobs) {
     Statistics stats;
     init_statistics(&stats);
 
-    // Sort jobs by arrival time
-    for (int i = 0; i < num_jobs - 1; i++) {
-        for (int j = 0; j < num_jobs - i - 1; j++) {
-            if (jobs[j]->arrival > jobs[j + 1]->arrival ||
-                (jobs[j]->arrival == jobs[j + 1]->arrival && jobs[j]->PID > jobs[j + 1]->PID)) {
-                Job *temp = jobs[j];
-                jobs[j] = jobs[j + 1];
-                jobs[j + 1] = temp;
-                // Swap states too
-                MLFQJobState temp_state = job_states[j];
-                job_states[j] = job_states[j + 1];
-                job_states[j + 1] = temp_state;
-            }
+    // Jobs arrive in arrival time / PID order. Submitted jobs are added to
+    // the cursor's job table, never to the caller's array.
+    ArrivalCursor *arrivals = create_arrival_cursor(jobs, num_jobs, capacity);
+    QueueNode **io_nodes = (QueueNode**)malloc(sizeof(QueueNode*) * (capacity > 0 ? capacity : 1));
+    DrawBatch io_draws = { NULL, NULL };  // One I/O check per queued job
+    if (arrivals == NULL || job_states == NULL || io_nodes == NULL || init_draw_batch(&io_draws, capacity) != 0) {
+        fprintf(stderr, "MLFQ scheduler: failed to allocate job table\n");
+        for (int i = 0; i < MLFQ_NUM_QUEUES; i++) {
+            destroy_queue(mlfq[i]);
         }
+        destroy_queue(io_queue);
+        destroy_arrival_cursor(arrivals);
+        free(io_nodes);
+        free(job_states);
+        return;
     }
+    jobs = arrivals->jobs;  // Job of each job_states index
 
     // Main scheduling loop
     while (1) {
-        // Rule 5: Priority boost every MLFQ_BOOST_INTERVAL time units
-        if (boost_counter >= MLFQ_BOOST_INTERVAL) {
-            // Move all jobs from all queues to queue 0
-            for (int level = 1; level < MLFQ_NUM_QUEUES; level++) {
-                while (!is_empty(mlfq[level])) {
-                    Job *job = dequeue(mlfq[level]);
-                    // Find job index
-                    for (int i = 0; i < num_jobs; i++) {
-                        if (jobs[i] == job) {
-                            job_states[i].current_queue_level = 0;
-                            job_states[i].time_slice_used = 0;
-                            break;
-                        }
+        // Rule 5: Priority boost every config->mlfq_boost_interval time units
+        if (boost_counter >= config->mlfq_boost_interval) {
+            boost_priorities(mlfq, job_states, current_job_index);
+            boost_counter = 0;
+        }
+
+        // Take submitted jobs; with nothing left to run, wait for the next one
+        int idle = (current_job == NULL && is_empty(io_queue) && arrival_cursor_pending(arrivals) == 0);
+        for (int level = 0; idle && level < MLFQ_NUM_QUEUES; level++) {
+            idle = is_empty(mlfq[level]);
+        }
+        Job *submitted;
+        while ((submitted = take_submitted_job(submissions, current_clock(sim), idle)) != NULL) {
+            job_states[arrival_cursor_insert(arrivals, submitted)] = (MLFQJobState){0};
+            idle = 0;
+        }
+        if (idle && submissions != NULL) {
+            break;
+        }
+
+        // Fast-forward: with nothing queued, jump over idle ticks, or run the
+        // lone job without Steps 1-4 until it leaves the CPU or the next job
+        // arrives. Skipped steps are no-ops (a boost only resets the lone
+        // job's level), and the draws are the same, so output is unchanged.
+        if (config != NULL && config->fast_forward && submissions_finished(submissions) &&
+            all_levels_empty(mlfq) && is_empty(io_queue)) {
+            SimTime next_arrival = arrival_cursor_peek_time(arrivals);
+            SimTime limit = (next_arrival < horizon_limit(config)) ? next_arrival : horizon_limit(config);
+            SimTime now = current_clock(sim);
+            if (limit > now && current_job == NULL && next_arrival != SIM_TIME_MAX) {
+                // Each skipped tick counts towards the next (no-op) boost
+                SimTime skipped = limit - now;
+                boost_counter = (int)((boost_counter + skipped - 1) % config->mlfq_boost_interval) + 1;
+                advance_clock_to(sim, limit);
+                continue;
+            }
+            if (limit > now && current_job != NULL) {
+                while (1) {
+                    run_current_job(sim, &current_job, &current_job_index, &current_time_slice,
+                                    job_states, mlfq, io_queue, &stats, config);
+                    next_tick(sim);
+                    boost_counter++;
+                    if (current_job == NULL || current_clock(sim) >= limit) {
+                        break;
+                    }
+                    if (boost_counter >= config->mlfq_boost_interval) {
+                        boost_priorities(mlfq, job_states, current_job_index);
+                        boost_counter = 0;
                     }
-                    int run_time = job->info.total - job->info.ready - job->info.sleep;
-                    int remaining = job->service - run_time;
-                    enqueue(mlfq[0], job, remaining);
                 }
-            }
-
-            // If current job is not in queue 0, move it too
-            if (current_job != NULL && current_job_index >= 0) {
-                if (job_states[current_job_index].current_queue_level > 0) {
-                    job_states[current_job_index].current_queue_level = 0;
-                    job_states[current_job_index].time_slice_used = 0;
+                if (current_job == NULL && all_levels_empty(mlfq) &&
+                    is_empty(io_queue) && arrival_cursor_pending(arrivals) == 0) {
+                    break;
                 }
+                continue;
             }
-
-            boost_counter = 0;
         }
 
         // Step 1: Add new incoming jobs to highest priority queue (Rule 3)
-        while (next_job_index < num_jobs && jobs[next_job_index]->arrival == current_clock()) {
-            Job *new_job = jobs[next_job_index];
-            job_states[next_job_index].current_queue_level = 0;  // Rule 3
-            job_states[next_job_index].time_slice_used = 0;
-            int remaining = new_job->service;
-            enqueue(mlfq[0], new_job, remaining);
-            next_job_index++;
+        int new_index;
+        while ((new_index = arrival_cursor_next(arrivals, current_clock(sim))) >= 0) {
+            Job *new_job = jobs[new_index];
+            job_states[new_index].current_queue_level = 0;  // Rule 3
+            job_states[new_index].time_slice_used = 0;
+            job_states[new_index].since = current_clock(sim);
+            SimTime remaining = new_job->service;
+            enqueue_node(mlfq[0], &job_states[new_index].link, new_job, remaining);
         }
 
         // Step 2: Check I/O completions (in FIFO order)
-        QueueNode *io_node = io_queue->head;
-        QueueNode *prev_io_node = NULL;
-        while (io_node != NULL) {
-            if (IO_complete()) {
-                Job *completed_io_job = io_node->job;
-                QueueNode *next = io_node->next;
-
-                // Find job index
-                int job_idx = -1;
-                for (int i = 0; i < num_jobs; i++) {
-                    if (jobs[i] == completed_io_job) {
-                        job_idx = i;
-                        break;
-                    }
-                }
+        // Take the I/O queue out and draw for all of it in one batch:
+        // completed jobs leave, the rest are re-enqueued in their original order.
+        int io_pending = queue_size(io_queue);
+        for (int k = 0; k < io_pending; k++) {
+            io_nodes[k] = dequeue_node(io_queue);
+            io_draws.pids[k] = io_nodes[k]->job->PID;
+        }
+        IO_complete_batch(sim, &io_draws, io_pending);
+        for (int k = 0; k < io_pending; k++) {
+            int job_idx = job_index_of(io_nodes[k], job_states);
+            Job *io_job = jobs[job_idx];
+            SimTime run_time = io_job->info.total - io_job->info.ready - io_job->info.sleep;
+            SimTime remaining = io_job->service - run_time;
+            if (!io_draws.outcomes[k]) {
+                enqueue_node(io_queue, &job_states[job_idx].link, io_job, remaining);
+                continue;
+            }
 
-                // Remove from I/O queue
-                if (prev_io_node == NULL) {
-                    io_queue->head = next;
-                } else {
-                    prev_io_node->next = next;
-                }
-                if (next == NULL) {
-                    io_queue->tail = prev_io_node;
-                }
-                io_queue->size--;
-                free(io_node);
-
-                // Rule 4: Job didn't use full time slice (I/O), keep same priority
-                if (job_idx >= 0) {
-                    int level = job_states[job_idx].current_queue_level;
-                    job_states[job_idx].time_slice_used = 0;  // Reset time slice
-                    int run_time = completed_io_job->info.total - completed_io_job->info.ready - completed_io_job->info.sleep;
-                    int remaining = completed_io_job->service - run_time;
-                    enqueue(mlfq[level], completed_io_job, remaining);
-                }
+            // Ticks after the request up to (not including) this check were spent sleeping
+            sleep_span(io_job, current_clock(sim) - job_states[job_idx].since);
+            job_states[job_idx].since = current_clock(sim);
 
-                io_node = next;
-            } else {
-                prev_io_node = io_node;
-                io_node = io_node->next;
-            }
+            // Rule 4: Job didn't use full time slice (I/O), keep same priority
+            int level = job_states[job_idx].current_queue_level;
+            job_states[job_idx].time_slice_used = 0;  // Reset time slice
+            enqueue_node(mlfq[level], &job_states[job_idx].link, io_job, remaining);
         }
 
         // Step 3: If no current job, select next from highest priority non-empty queue (Rule 1 & 2)
         if (current_job == NULL) {
             for (int level = 0; level < MLFQ_NUM_QUEUES; level++) {
                 if (!is_empty(mlfq[level])) {
-                    current_job = dequeue(mlfq[level]);
-
-                    // Find job index
-                    for (int i = 0; i < num_jobs; i++) {
-                        if (jobs[i] == current_job) {
-                            current_job_index = i;
-                            break;
-                        }
-                    }
+                    current_job_index = job_index_of(dequeue_node(mlfq[level]), job_states);
+                    current_job = jobs[current_job_index];
+                    job_states[current_job_index].current_queue_level = level;
+                    // Step 4: charge the time spent waiting in the queue
+                    wait_span(current_job, current_clock(sim) - job_states[current_job_index].since);
 
                     current_time_slice = 0;
                     break;
@@ -228,95 +338,52 @@ void run_mlfq_scheduler(Job **jobs, int num_jobs) {
             }
         }
 
-        // Step 4: Update waiting times for jobs in all queues (BEFORE running current job)
-        for (int level = 0; level < MLFQ_NUM_QUEUES; level++) {
-            QueueNode *node = mlfq[level]->head;
-            while (node != NULL) {
-                wait(node->job);
-                node = node->next;
-            }
-        }
-
-        QueueNode *node = io_queue->head;
-        while (node != NULL) {
-            sleep(node->job);
-            node = node->next;
-        }
-
         // Step 5: Run current job
         if (current_job != NULL && current_job_index >= 0) {
-            run(current_job);
-            job_states[current_job_index].time_slice_used++;
-            current_time_slice++;
-
-            // Check if job is complete (check CPU time, not total time)
-            int run_time = current_job->info.total - current_job->info.ready - current_job->info.sleep;
-            if (run_time >= current_job->service) {
-                // Job completed
-                update_statistics(&stats, current_job, current_clock() + 1);
-                current_job = NULL;
-                current_job_index = -1;
-            } else {
-                // Check for I/O request
-                if (IO_request()) {
-                    // Move to I/O queue (Rule 4: didn't use full slice, keep priority)
-                    int remaining = current_job->service - run_time;
-                    enqueue(io_queue, current_job, remaining);
-                    current_job = NULL;
-                    current_job_index = -1;
-                } else if (job_states[current_job_index].time_slice_used >= get_time_slice(job_states[current_job_index].current_queue_level)) {
-                    // Rule 4: Used full time slice, demote to lower queue
-                    int current_level = job_states[current_job_index].current_queue_level;
-                    if (current_level < MLFQ_NUM_QUEUES - 1) {
-                        job_states[current_job_index].current_queue_level++;
-                    }
-                    job_states[current_job_index].time_slice_used = 0;
-
-                    int remaining = current_job->service - run_time;
-                    enqueue(mlfq[job_states[current_job_index].current_queue_level], current_job, remaining);
-                    current_job = NULL;
-                    current_job_index = -1;
-                }
-            }
+            run_current_job(sim, &current_job, &current_job_index, &current_time_slice,
+                            job_states, mlfq, io_queue, &stats, config);
         }
 
         // Increment clock and boost counter
-        next_tick();
+        next_tick(sim);
         boost_counter++;
 
         // Check termination condition
-        int all_queues_empty = 1;
-        for (int level = 0; level < MLFQ_NUM_QUEUES; level++) {
-            if (!is_empty(mlfq[level])) {
-                all_queues_empty = 0;
-                break;
-            }
-        }
-
-        if (current_job == NULL && all_queues_empty &&
-            is_empty(io_queue) && next_job_index >= num_jobs) {
+        if (current_job == NULL && all_levels_empty(mlfq) &&
+            is_empty(io_queue) && arrival_cursor_pending(arrivals) == 0 &&
+            submissions_finished(submissions)) {
             break;
         }
 
-        // Safety check
-        if (current_clock() > 100000) {
-            printf("Error: Simulation exceeded maximum time limit\n");
+        if (past_horizon(config, current_clock(sim))) {
             break;
         }
     }
 
-    stats.total_simulation_time = current_clock();
+    stats.total_simulation_time = current_clock(sim);
 
 
     // Cleanup
     for (int i = 0; i < MLFQ_NUM_QUEUES; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "level %d", i);
+        collect_queue_stats(sim, name, mlfq[i]);
+        charge_open_spans(sim, mlfq[i], job_states, wait_span);
         destroy_queue(mlfq[i]);
     }
+    collect_queue_stats(sim, "io", io_queue);
+    charge_open_spans(sim, io_queue, job_states, sleep_span);
     destroy_queue(io_queue);
+    free_draw_batch(&io_draws);
+    free(io_nodes);
     free(job_states);
+    destroy_arrival_cursor(arrivals);
 }
 
 // Wrapper function to match scheduler.h interface
-void schedule_mlfq(Job **jobs, int n) {
-    run_mlfq_scheduler(jobs, n);
+void schedule_mlfq(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config) {
+    if (config == NULL) {
+        return;
+    }
+    run_mlfq_scheduler(sim, jobs, n, config);
 }
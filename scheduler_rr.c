@@ -2,6 +2,7 @@
 #include <stdlib.h>
 
 #include "include/scheduler.h"
+#include "include/arrival_cursor.h"
 #include "include/job.h"
 #include "include/queue.h"
 #include "include/utils.h"
@@ -19,180 +20,249 @@ typedef enum {
 
 typedef struct {
     Job *job;
-    int remaining_time;
+    SimTime remaining_time;
     int time_slice_used;
     RRJobState state;
+    SimTime since;      // First tick of the current READY/IO span, charged when the job leaves
+    QueueNode link;     // Ready/I/O queue links, embedded so queue operations never allocate
 } RRJobContext;
 
 
 // --- Helper Functions (Patterned after SJF/MLFQ) ---
 
 /**
- * @brief qsort comparison function. Sorts by arrival time, then PID.
+ * @brief Helper to get the context that embeds a queue node.
  */
-static int compare_jobs_for_sort(const void *a, const void *b) {
-    RRJobContext *ctxA = (RRJobContext *)a;
-    RRJobContext *ctxB = (RRJobContext *)b;
-
-    if (ctxA->job->arrival < ctxB->job->arrival) return -1;
-    if (ctxA->job->arrival > ctxB->job->arrival) return 1;
-
-    // Arrival times are equal, use PID for tie-breaking
-    if (ctxA->job->PID < ctxB->job->PID) return -1;
-    if (ctxA->job->PID > ctxB->job->PID) return 1;
+static RRJobContext *context_of(QueueNode *node) {
+    if (node == NULL) {
+        return NULL;
+    }
+    return queue_node_container(node, RRJobContext, link);
+}
 
-    return 0;
+/**
+ * @brief Links a context into a queue through its embedded node.
+ */
+static void enqueue_context(Queue *queue, RRJobContext *ctx) {
+    enqueue_node(queue, &ctx->link, ctx->job, ctx->remaining_time);
 }
 
 /**
- * @brief Helper to find the context for a given job pointer.
+ * @brief Sets up the context of a job that has not arrived yet.
  */
-static RRJobContext *find_context(RRJobContext *contexts, int count, Job *job) {
-    if (job == NULL) {
-        return NULL;
-    }
-    for (int i = 0; i < count; ++i) {
-        if (contexts[i].job == job) {
-            return &contexts[i];
-        }
-    }
-    return NULL;
+static void init_context(RRJobContext *ctx, Job *job) {
+    ctx->job = job;
+    ctx->remaining_time = (job != NULL) ? job->service : 0;
+    ctx->state = RR_JOB_STATE_NEW;
+    ctx->time_slice_used = 0;
 }
 
 /**
  * @brief Handles I/O completions.
  * Iterates I/O queue, calls IO_complete(), and moves finished jobs to ready_queue.
  * Handles PID tie-breaking for simultaneous completions.
+ * completed_jobs and draws are scratch space with room for every job,
+ * allocated once per run, so a tick never allocates however many jobs are in
+ * I/O. The queue is taken out into completed_jobs, drawn for in one batch and
+ * compacted in place to the jobs finishing I/O.
+ * Every check, including the successful one, counts as a tick of sleep.
  */
-static void process_io_queue(Queue* io_queue, Queue* ready_queue, RRJobContext* contexts, int n) {
+static void process_io_queue(SimContext *sim, Queue* io_queue, Queue* ready_queue, QueueNode **completed_jobs,
+                             DrawBatch *draws, SimTime clock_tick) {
     int io_q_size = queue_size(io_queue);
     if (io_q_size == 0) {
         return;
     }
 
-    // Temp list for jobs that completed I/O this tick
-    Job* completed_jobs[io_q_size];
     int completed_count = 0;
-
-    Queue* temp_io_queue = create_queue(QUEUE_FIFO);
-
-    // 1. Iterate I/O queue, check for completions
     for (int i = 0; i < io_q_size; i++) {
-        Job* job = dequeue(io_queue);
-        RRJobContext* ctx = find_context(contexts, n, job);
+        completed_jobs[i] = dequeue_node(io_queue);
+        draws->pids[i] = completed_jobs[i]->job->PID;
+    }
+    IO_complete_batch(sim, draws, io_q_size);
 
-        // Call sleep() before IO_complete()
-        // Job was in I/O queue for a tick
-        if (ctx) sleep(ctx->job);
+    // 1. Sweep the I/O jobs once: completed jobs leave, the rest are
+    // re-enqueued in their original order
+    for (int i = 0; i < io_q_size; i++) {
+        RRJobContext* ctx = context_of(completed_jobs[i]);
 
-        if (IO_complete() == 1) { // I/O complete
-            completed_jobs[completed_count++] = job;
+        if (draws->outcomes[i]) { // I/O complete
+            sleep_span(ctx->job, clock_tick + 1 - ctx->since);
+            completed_jobs[completed_count++] = &ctx->link;
         } else { // I/O not complete
-            enqueue(temp_io_queue, job, ctx ? ctx->remaining_time : 0);
+            enqueue_context(io_queue, ctx);
         }
     }
 
-    // 2. Re-enqueue pending I/O jobs
-    while (!is_empty(temp_io_queue)) {
-        enqueue(io_queue, dequeue(temp_io_queue), 0);
-    }
-    destroy_queue(temp_io_queue);
-
-    // 3. Handle ties: sort completed jobs by PID
-    if (completed_count > 1) {
-        for (int i = 1; i < completed_count; i++) {
-            Job* key = completed_jobs[i];
-            int j = i - 1;
-            while (j >= 0 && completed_jobs[j]->PID > key->PID) {
-                completed_jobs[j + 1] = completed_jobs[j];
-                j = j - 1;
-            }
-            completed_jobs[j + 1] = key;
-        }
-    }
+    // 2. Handle ties: sort completed jobs by PID (in place, no allocation)
+    sort_nodes_by_pid(completed_jobs, completed_count);
 
-    // 4. Enqueue completed jobs to ready queue (by PID)
+    // 3. Enqueue completed jobs to ready queue (by PID)
     for (int i = 0; i < completed_count; i++) {
-        RRJobContext* ctx = find_context(contexts, n, completed_jobs[i]);
-        if (ctx) {
-            ctx->state = RR_JOB_STATE_READY;
-            ctx->time_slice_used = 0; // Reset time slice on I/O completion
-            enqueue(ready_queue, ctx->job, ctx->remaining_time);
-        }
+        RRJobContext* ctx = context_of(completed_jobs[i]);
+        ctx->state = RR_JOB_STATE_READY;
+        ctx->since = clock_tick;
+        ctx->time_slice_used = 0; // Reset time slice on I/O completion
+        ctx->link.remaining_time = ctx->remaining_time;
     }
+    enqueue_nodes(ready_queue, completed_jobs, completed_count);
 }
 
 /**
- * @brief Iterates ready queue to accumulate wait time.
- * (I/O sleep time is handled in process_io_queue)
+ * @brief Charges the open READY/IO spans of jobs still waiting when the
+ * simulation stops (e.g. at the horizon).
  */
-static void accumulate_ready_queue_stats(Queue* ready_queue) {
-    // Accumulate wait time for jobs in ready queue
-    QueueNode *node = ready_queue->head;
-    while (node != NULL) {
-        wait(node->job);
-        node = node->next;
+static void flush_pending_spans(RRJobContext *contexts, int count, SimTime clock_tick) {
+    for (int i = 0; i < count; i++) {
+        if (contexts[i].state == RR_JOB_STATE_READY) {
+            wait_span(contexts[i].job, clock_tick - contexts[i].since);
+        } else if (contexts[i].state == RR_JOB_STATE_IO) {
+            sleep_span(contexts[i].job, clock_tick - contexts[i].since);
+        }
     }
 }
 
 
+/**
+ * @brief Runs the current job for one tick (Step 6).
+ * The job leaves the CPU when it completes or requests I/O.
+ */
+static void run_current(SimContext *sim, RRJobContext **current, Queue *io_queue, int *completed_jobs) {
+    RRJobContext *ctx = *current;
+    run(ctx->job);
+    ctx->remaining_time--;
+    ctx->time_slice_used++;
+
+    // Check for Job Completion
+    if (ctx->remaining_time <= 0) {
+        ctx->state = RR_JOB_STATE_DONE;
+        (*completed_jobs)++;
+        *current = NULL;
+    }
+    // Check for I/O Request
+    else if (IO_request(sim, ctx->job->PID)) {
+        ctx->state = RR_JOB_STATE_IO;
+        ctx->since = current_clock(sim) + 1; // First I/O check is next tick
+        enqueue_context(io_queue, ctx);
+        *current = NULL;
+    }
+}
+
 // --- Main Round Robin Scheduler Function ---
 
-void schedule_rr(Job** jobs, int n, int time_quantum) {
-    if (jobs == NULL || n <= 0) {
+void schedule_rr(SimContext *sim, Job** jobs, int n, const SchedulerConfig *config) {
+    if (n < 0 || (n > 0 && jobs == NULL) || config == NULL) {
         return;
     }
 
+    int time_quantum = config->time_quantum;
+
     // 1. Initialization
-    RRJobContext *contexts = (RRJobContext*)malloc(sizeof(RRJobContext) * n);
+    // Room for submitted jobs is reserved up front so queue links never move
+    SubmissionQueue *submissions = config->submissions;
+    int capacity = n + submission_capacity(submissions);
+    if (capacity <= 0) {
+        return;
+    }
+    RRJobContext *contexts = (RRJobContext*)calloc(capacity, sizeof(RRJobContext));
     if (contexts == NULL) {
         fprintf(stderr, "RR scheduler: failed to allocate job context array\n");
         return;
     }
 
     for (int i = 0; i < n; ++i) {
-        contexts[i].job = jobs[i];
-        contexts[i].remaining_time = (jobs[i] != NULL) ? jobs[i]->service : 0;
-        contexts[i].state = RR_JOB_STATE_NEW;
-        contexts[i].time_slice_used = 0;
+        init_context(&contexts[i], jobs[i]);
         // Ensure Job's info struct is initialized
         // init_Job(contexts[i].job, jobs[i]->PID, jobs[i]->arrival, jobs[i]->service, jobs[i]->priority);
     }
 
-    // Sort contexts by arrival time / PID (like MLFQ)
-    qsort(contexts, n, sizeof(RRJobContext), compare_jobs_for_sort);
+    // Contexts arrive in arrival time / PID order (like MLFQ)
+    ArrivalCursor *arrivals = create_arrival_cursor(jobs, n, capacity);
+    if (arrivals == NULL) {
+        fprintf(stderr, "RR scheduler: failed to build arrival order\n");
+        free(contexts);
+        return;
+    }
+
+    // Jobs finishing I/O in one tick, ordered by PID before they become ready
+    QueueNode **io_completions = (QueueNode**)malloc(sizeof(QueueNode*) * capacity);
+    DrawBatch io_draws;
+    if (io_completions == NULL || init_draw_batch(&io_draws, capacity) != 0) {
+        fprintf(stderr, "RR scheduler: failed to allocate I/O completion buffer\n");
+        free(io_completions);
+        destroy_arrival_cursor(arrivals);
+        free(contexts);
+        return;
+    }
 
-    Queue *ready_queue = create_queue(QUEUE_FIFO);
-    Queue *io_queue = create_queue(QUEUE_FIFO);
+    Queue *ready_queue = create_queue(QUEUE_FIFO_RING);
+    Queue *io_queue = create_queue(QUEUE_FIFO_RING);
+    enable_queue_stats(sim, ready_queue);
+    enable_queue_stats(sim, io_queue);
     // Global_Info stats_info;
 
     // init_global_info(&stats_info);
-    init_clock();
+    init_clock(sim);
     // os_srand(1); // Required by PDF for determinism
 
     int completed_jobs = 0;
-    int next_job_index = 0; // Tracks next job in sorted context array
+    int count = n;          // Preloaded plus submitted jobs
     RRJobContext *current_job_ctx = NULL;
 
-    int total_jobs_in_system = 0;
-
     // 2. Main Simulation Loop
-    while (completed_jobs < n) {
-        int clock_tick = current_clock();
+    while (completed_jobs < count || !submissions_finished(submissions)) {
+        SimTime clock_tick = current_clock(sim);
+
+        // Take submitted jobs; with nothing left to run, wait for the next one
+        int idle = (current_job_ctx == NULL && is_empty(ready_queue) && is_empty(io_queue) &&
+                    arrival_cursor_pending(arrivals) == 0);
+        Job *submitted;
+        while ((submitted = take_submitted_job(submissions, clock_tick, idle)) != NULL) {
+            init_context(&contexts[arrival_cursor_insert(arrivals, submitted)], submitted);
+            count++;
+            idle = 0;
+        }
+        if (idle) {
+            break;
+        }
 
         // Flag: is any job running or waiting?
         // int job_running_or_waiting = 0;
 
+        // Fast-forward: with nothing queued, jump over idle ticks, or run the
+        // lone job tick by tick without the other steps until it leaves the
+        // CPU or the next job arrives. The skipped steps are no-ops (a slice
+        // expiry just re-dispatches the same job) and the draws are the same.
+        if (config->fast_forward && submissions_finished(submissions) &&
+            is_empty(ready_queue) && is_empty(io_queue)) {
+            SimTime next_arrival = arrival_cursor_peek_time(arrivals);
+            SimTime limit = (next_arrival < horizon_limit(config)) ? next_arrival : horizon_limit(config);
+            if (limit > clock_tick && current_job_ctx == NULL && next_arrival != SIM_TIME_MAX) {
+                advance_clock_to(sim, limit);
+                continue;
+            }
+            if (limit > clock_tick && current_job_ctx != NULL) {
+                while (current_job_ctx != NULL && current_clock(sim) < limit) {
+                    if (current_job_ctx->time_slice_used >= time_quantum) {
+                        current_job_ctx->time_slice_used = 0;
+                    }
+                    run_current(sim, &current_job_ctx, io_queue, &completed_jobs);
+                    next_tick(sim);
+                }
+                continue;
+            }
+        }
+
         // Step 1: Enqueue new arrivals
-        while (next_job_index < n && contexts[next_job_index].job->arrival <= clock_tick) {
-            contexts[next_job_index].state = RR_JOB_STATE_READY;
-            enqueue(ready_queue, contexts[next_job_index].job, contexts[next_job_index].remaining_time);
-            next_job_index++;
-            total_jobs_in_system++;
+        int arrived;
+        while ((arrived = arrival_cursor_next(arrivals, clock_tick)) >= 0) {
+            contexts[arrived].state = RR_JOB_STATE_READY;
+            contexts[arrived].since = clock_tick;
+            enqueue_context(ready_queue, &contexts[arrived]);
         }
 
         // Step 2: Process I/O completions (Strict PDF order)
-        process_io_queue(io_queue, ready_queue, contexts, n);
+        process_io_queue(sim, io_queue, ready_queue, io_completions, &io_draws, clock_tick);
 
         // Step 3: Handle running job logic
         if (current_job_ctx != NULL) {
@@ -200,46 +270,27 @@ void schedule_rr(Job** jobs, int n, int time_quantum) {
             // Check for Time Slice Expiry
             if (current_job_ctx->time_slice_used >= time_quantum) {
                 current_job_ctx->state = RR_JOB_STATE_READY;
-                enqueue(ready_queue, current_job_ctx->job, current_job_ctx->remaining_time);
+                current_job_ctx->since = clock_tick;
+                enqueue_context(ready_queue, current_job_ctx);
                 current_job_ctx = NULL;
             }
         }
 
         // Step 4: Select new job if CPU is idle
         if (current_job_ctx == NULL) {
-            Job *next_job = dequeue(ready_queue);
-            if (next_job != NULL) {
-                current_job_ctx = find_context(contexts, n, next_job);
+            current_job_ctx = context_of(dequeue_node(ready_queue));
+            if (current_job_ctx != NULL) {
                 current_job_ctx->state = RR_JOB_STATE_RUNNING;
                 current_job_ctx->time_slice_used = 0; // Reset time slice
+                // Step 5: Charge the wait since the job entered the ready queue
+                wait_span(current_job_ctx->job, clock_tick - current_job_ctx->since);
             }
         }
 
-        // Step 5: Accumulate stats for waiting jobs
-        accumulate_ready_queue_stats(ready_queue);
-
         // Step 6: Run the current job
         if (current_job_ctx != NULL) {
             // job_running_or_waiting = 1; // Mark CPU as active
-            run(current_job_ctx->job);
-            current_job_ctx->remaining_time--;
-            current_job_ctx->time_slice_used++;
-
-            // Check for Job Completion
-            if (current_job_ctx->remaining_time <= 0) {
-                current_job_ctx->state = RR_JOB_STATE_DONE;
-                //current_job_ctx->job->info.completion_time = clock_tick + 1; // Job completes at tick+1
-                //current_job_ctx->job->info.total = current_job_ctx->job->info.completion_time - current_job_ctx->job->arrival;
-                completed_jobs++;
-                total_jobs_in_system--;
-                current_job_ctx = NULL;
-            }
-            // Check for I/O Request
-            else if (IO_request()) {
-                current_job_ctx->state = RR_JOB_STATE_IO;
-                enqueue(io_queue, current_job_ctx->job, current_job_ctx->remaining_time);
-                current_job_ctx = NULL;
-            }
+            run_current(sim, &current_job_ctx, io_queue, &completed_jobs);
         }
 
         // Check if any job is in I/O queue
@@ -255,15 +306,14 @@ void schedule_rr(Job** jobs, int n, int time_quantum) {
         // then exit.
 
         // Step 7: Advance clock
-        next_tick();
+        next_tick(sim);
 
-        if (current_job_ctx == NULL && is_empty(ready_queue) && is_empty(io_queue) && next_job_index >= n) {
+        if (current_job_ctx == NULL && is_empty(ready_queue) && is_empty(io_queue) && arrival_cursor_pending(arrivals) == 0 &&
+            submissions_finished(submissions)) {
              break; // All jobs are processed
         }
 
-        // Safety break
-        if (clock_tick > 200000) {
-            fprintf(stderr, "Error: RR simulation exceeded maximum time limit\n");
+        if (past_horizon(config, current_clock(sim))) {
             break;
         }
     }
@@ -272,9 +322,16 @@ void schedule_rr(Job** jobs, int n, int time_quantum) {
     // Must pass original 'jobs' array to stats
     //calculate_and_print_final_stats(&stats_info, jobs, n, current_clock());
 
+    flush_pending_spans(contexts, count, current_clock(sim));
+
     // 4. Cleanup
+    collect_queue_stats(sim, "ready", ready_queue);
+    collect_queue_stats(sim, "io", io_queue);
     destroy_queue(io_queue);
     destroy_queue(ready_queue);
+    destroy_arrival_cursor(arrivals);
+    free_draw_batch(&io_draws);
+    free(io_completions);
     free(contexts);
 }
 
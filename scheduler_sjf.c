@@ -3,10 +3,17 @@
 #include <stdbool.h>
 
 #include "include/scheduler.h"
+#include "include/arrival_cursor.h"
 #include "include/queue.h"
 #include "include/clock.h"
 #include "include/utils.h"
 
+// Ready queue backend: QUEUE_SJF_HEAP (O(log n) enqueue/dequeue) or the
+// sorted-list QUEUE_SJF. Override with -DSJF_READY_QUEUE_TYPE=QUEUE_SJF.
+#ifndef SJF_READY_QUEUE_TYPE
+#define SJF_READY_QUEUE_TYPE QUEUE_SJF_HEAP
+#endif
+
 typedef enum {
     JOB_STATE_NEW = 0,
     JOB_STATE_READY,
@@ -17,158 +24,255 @@ typedef enum {
 
 typedef struct {
     Job *job;
-    int remaining_time;
+    SimTime remaining_time;
     // bool isStarted;
     SJFJobState state;
+    SimTime since;      // First tick of the current READY/IO span, charged when the job leaves
+    QueueNode link;     // Ready/I/O queue links, embedded so queue operations never allocate
 } SJFJobContext;
 
-static SJFJobContext *find_context(SJFJobContext *contexts, int count, Job *job) {
-    if (job == NULL) {
+static SJFJobContext *context_of(QueueNode *node) {
+    if (node == NULL) {
         return NULL;
     }
-    for (int i = 0; i < count; ++i) {
-        if (contexts[i].job == job) {
-            return &contexts[i];
-        }
-    }
-    return NULL;
+    return queue_node_container(node, SJFJobContext, link);
 }
 
-static void enqueue_new_arrivals(SJFJobContext *contexts, int count, int clock_tick, Queue *ready_queue) {
-    for (int i = 0; i < count; ++i) {
-        if (contexts[i].state == JOB_STATE_NEW && contexts[i].job->arrival <= clock_tick) {
-            enqueue(ready_queue, contexts[i].job, contexts[i].remaining_time);
-            contexts[i].state = JOB_STATE_READY;
-        }
+static void enqueue_context(Queue *queue, SJFJobContext *ctx) {
+    enqueue_node(queue, &ctx->link, ctx->job, ctx->remaining_time);
+}
+
+static void enqueue_new_arrivals(SJFJobContext *contexts, ArrivalCursor *arrivals, SimTime clock_tick, Queue *ready_queue) {
+    int i;
+    while ((i = arrival_cursor_next(arrivals, clock_tick)) >= 0) {
+        enqueue_context(ready_queue, &contexts[i]);
+        contexts[i].state = JOB_STATE_READY;
+        contexts[i].since = clock_tick;
     }
 }
 
-static void process_io_queue(Queue *io_queue, Queue *ready_queue, SJFJobContext *contexts, int count) {
+// completed and draws are scratch space with room for every job. The queue
+// is taken out into completed, the IO_complete() draws for all of it are made
+// in one batch, then completed is compacted in place to the jobs finishing
+// I/O, which go to the ready queue in one batch. Every check, including the
+// successful one, counts as a tick of sleep.
+static void process_io_queue(SimContext *sim, Queue *io_queue, Queue *ready_queue, QueueNode **completed,
+                             DrawBatch *draws, SimTime clock_tick) {
     if (io_queue == NULL) {
         return;
     }
 
+    int completed_count = 0;
     int pending = queue_size(io_queue);
     for (int i = 0; i < pending; ++i) {
-        Job *job = dequeue(io_queue);
-        if (job == NULL) {
-            continue;
-        }
-
-        SJFJobContext *ctx = find_context(contexts, count, job);
-        if (ctx == NULL) {
-            continue;
-        }
+        completed[i] = dequeue_node(io_queue);
+        draws->pids[i] = completed[i]->job->PID;
+    }
+    IO_complete_batch(sim, draws, pending);
 
-        sleep(job);
-        if (IO_complete()) {
+    for (int i = 0; i < pending; ++i) {
+        SJFJobContext *ctx = context_of(completed[i]);
+        if (draws->outcomes[i]) {
+            sleep_span(ctx->job, clock_tick + 1 - ctx->since);
             ctx->state = JOB_STATE_READY;
-            enqueue(ready_queue, job, ctx->remaining_time);
+            ctx->since = clock_tick;
+            ctx->link.remaining_time = ctx->remaining_time;
+            completed[completed_count++] = &ctx->link;
         } else {
-            enqueue(io_queue, job, ctx->remaining_time);
+            enqueue_context(io_queue, ctx);
         }
     }
+
+    enqueue_nodes(ready_queue, completed, completed_count);
 }
 
-static void accumulate_wait_time(SJFJobContext *contexts, int count) {
+// Charge the open READY/IO spans of jobs still waiting when the loop ends
+static void flush_pending_spans(SJFJobContext *contexts, int count, SimTime clock_tick) {
     for (int i = 0; i < count; ++i) {
-        // if (contexts[i].state == JOB_STATE_READY && contexts[i].isStarted == false) {
         if (contexts[i].state == JOB_STATE_READY) {
-            wait(contexts[i].job);
+            wait_span(contexts[i].job, clock_tick - contexts[i].since);
+        } else if (contexts[i].state == JOB_STATE_IO) {
+            sleep_span(contexts[i].job, clock_tick - contexts[i].since);
         }
     }
 }
 
-void schedule_sjf(Job **jobs, int n) {
-    if (jobs == NULL || n <= 0) {
+static void init_context(SJFJobContext *ctx, Job *job) {
+    ctx->job = job;
+    ctx->remaining_time = (job != NULL) ? job->service : 0;
+    // ctx->isStarted = false;
+    ctx->state = JOB_STATE_NEW;
+}
+
+// Run the current job for one tick; it leaves the CPU when it completes or requests I/O
+static void run_current(SimContext *sim, SJFJobContext **current, Queue *io_queue, int *completed_jobs) {
+    SJFJobContext *ctx = *current;
+    run(ctx->job);
+    ctx->remaining_time--;
+
+    if (ctx->remaining_time <= 0) {
+        ctx->state = JOB_STATE_DONE;
+        (*completed_jobs)++;
+        *current = NULL;
+    } else if (IO_request(sim, ctx->job->PID)) {
+        ctx->state = JOB_STATE_IO;
+        ctx->since = current_clock(sim) + 1;
+        enqueue_context(io_queue, ctx);
+        *current = NULL;
+    }
+}
+
+void schedule_sjf(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config) {
+    if (n < 0 || (n > 0 && jobs == NULL) || config == NULL) {
         return;
     }
 
-    SJFJobContext *contexts = (SJFJobContext*)malloc(sizeof(SJFJobContext) * n);
+    // Contexts for submitted jobs are reserved up front so embedded queue
+    // links never move
+    SubmissionQueue *submissions = config->submissions;
+    int capacity = n + submission_capacity(submissions);
+    if (capacity <= 0) {
+        return;
+    }
+
+    SJFJobContext *contexts = (SJFJobContext*)calloc(capacity, sizeof(SJFJobContext));
     if (contexts == NULL) {
         fprintf(stderr, "SJF scheduler: failed to allocate job context array\n");
         return;
     }
 
     for (int i = 0; i < n; ++i) {
-        contexts[i].job = jobs[i];
-        contexts[i].remaining_time = (jobs[i] != NULL) ? jobs[i]->service : 0;
-        // contexts[i].isStarted = false;
-        contexts[i].state = JOB_STATE_NEW;
+        init_context(&contexts[i], jobs[i]);
     }
+    int count = n;
 
-    Queue *ready_queue = create_queue(QUEUE_SJF);
+    ArrivalCursor *arrivals = create_arrival_cursor(jobs, n, capacity);
+    if (arrivals == NULL) {
+        fprintf(stderr, "SJF scheduler: failed to build arrival order\n");
+        free(contexts);
+        return;
+    }
+
+    QueueNode **io_completions = (QueueNode**)malloc(sizeof(QueueNode*) * capacity);
+    DrawBatch io_draws;
+    if (io_completions == NULL || init_draw_batch(&io_draws, capacity) != 0) {
+        fprintf(stderr, "SJF scheduler: failed to allocate I/O completion buffer\n");
+        free(io_completions);
+        destroy_arrival_cursor(arrivals);
+        free(contexts);
+        return;
+    }
+
+    Queue *ready_queue = create_queue(SJF_READY_QUEUE_TYPE);
     if (ready_queue == NULL) {
         fprintf(stderr, "SJF scheduler: failed to create ready queue\n");
+        free_draw_batch(&io_draws);
+        free(io_completions);
+        destroy_arrival_cursor(arrivals);
         free(contexts);
         return;
     }
 
-    Queue *io_queue = create_queue(QUEUE_FIFO);
+    Queue *io_queue = create_queue(QUEUE_FIFO_RING);
     if (io_queue == NULL) {
         fprintf(stderr, "SJF scheduler: failed to create I/O queue\n");
         destroy_queue(ready_queue);
+        free_draw_batch(&io_draws);
+        free(io_completions);
+        destroy_arrival_cursor(arrivals);
         free(contexts);
         return;
     }
 
-    init_clock();
+    enable_queue_stats(sim, ready_queue);
+    enable_queue_stats(sim, io_queue);
+
+    init_clock(sim);
     int completed_jobs = 0;
     SJFJobContext *current = NULL;
 
-    while (completed_jobs < n) {
-        int clock_tick = current_clock();
+    while (completed_jobs < count || !submissions_finished(submissions)) {
+        SimTime clock_tick = current_clock(sim);
 
-        enqueue_new_arrivals(contexts, n, clock_tick, ready_queue);
-        process_io_queue(io_queue, ready_queue, contexts, n);
+        // Every known job has finished: wait for the next submission
+        int idle = (completed_jobs == count);
+        Job *submitted;
+        while ((submitted = take_submitted_job(submissions, clock_tick, idle)) != NULL) {
+            init_context(&contexts[arrival_cursor_insert(arrivals, submitted)], submitted);
+            count++;
+            idle = 0;
+        }
+        if (completed_jobs == count) {
+            break;
+        }
+
+        // Fast-forward: with nothing queued, jump over idle ticks, or run the
+        // lone job without the per-tick scans until it leaves the CPU or the
+        // next job arrives. Skipped steps are no-ops and run_current() draws
+        // exactly as below, so the output is unchanged.
+        if (config->fast_forward && submissions_finished(submissions) &&
+            is_empty(ready_queue) && is_empty(io_queue)) {
+            SimTime next_arrival = arrival_cursor_peek_time(arrivals);
+            SimTime limit = (next_arrival < horizon_limit(config)) ? next_arrival : horizon_limit(config);
+            if (limit > clock_tick && next_arrival != SIM_TIME_MAX && current == NULL) {
+                advance_clock_to(sim, limit);
+                continue;
+            }
+            if (limit > clock_tick && current != NULL) {
+                while (current != NULL && current_clock(sim) < limit) {
+                    run_current(sim, &current, io_queue, &completed_jobs);
+                    next_tick(sim);
+                }
+                continue;
+            }
+        }
+
+        enqueue_new_arrivals(contexts, arrivals, clock_tick, ready_queue);
+        process_io_queue(sim, io_queue, ready_queue, io_completions, &io_draws, clock_tick);
 
         if (current != NULL && current->state == JOB_STATE_RUNNING) {
-            Job *head_job = peek(ready_queue);
-            SJFJobContext *candidate = find_context(contexts, n, head_job);
+            SJFJobContext *candidate = context_of(peek_node(ready_queue));
             if (candidate != NULL && candidate->remaining_time < current->remaining_time) {
                 current->state = JOB_STATE_READY;
-                enqueue(ready_queue, current->job, current->remaining_time);
+                current->since = clock_tick;
+                enqueue_context(ready_queue, current);
                 current = NULL;
             }
         }
 
         if (current == NULL) {
-            Job *next_job = dequeue(ready_queue);
-            if (next_job != NULL) {
-                current = find_context(contexts, n, next_job);
-                if (current != NULL) {
-                    current->state = JOB_STATE_RUNNING;
-                    // current->isStarted = true;
-                }
+            current = context_of(dequeue_node(ready_queue));
+            if (current != NULL) {
+                current->state = JOB_STATE_RUNNING;
+                wait_span(current->job, clock_tick - current->since);
+                // current->isStarted = true;
             }
         }
 
-        accumulate_wait_time(contexts, n);
-
         if (current != NULL && current->state == JOB_STATE_RUNNING) {
-            run(current->job);
-            current->remaining_time--;
-
-            if (current->remaining_time <= 0) {
-                current->state = JOB_STATE_DONE;
-                completed_jobs++;
-                current = NULL;
-            } else if (IO_request()) {
-                current->state = JOB_STATE_IO;
-                enqueue(io_queue, current->job, current->remaining_time);
-                current = NULL;
-            }
+            run_current(sim, &current, io_queue, &completed_jobs);
         }
 
-        next_tick();
+        next_tick(sim);
+
+        if (completed_jobs >= count && submissions_finished(submissions)) {
+            break;
+        }
 
-        if (completed_jobs >= n) {
+        if (past_horizon(config, current_clock(sim))) {
             break;
         }
     }
 
+    flush_pending_spans(contexts, count, current_clock(sim));
+
+    collect_queue_stats(sim, "ready", ready_queue);
+    collect_queue_stats(sim, "io", io_queue);
     destroy_queue(io_queue);
     destroy_queue(ready_queue);
+    free_draw_batch(&io_draws);
+    free(io_completions);
+    destroy_arrival_cursor(arrivals);
     free(contexts);
 }
 
@@ -0,0 +1,813 @@
+//
+// Multi-CPU Scheduler Engine
+// Implementation File
+//
+// Runs SJF, RR or MLFQ tick by tick on config->cpus simulated CPUs. Each CPU
+// has its own ready queue (the MLFQ levels for MLFQ) and the I/O device is
+// shared. A new job goes to the least loaded CPU and returns to the CPU it
+// last ran on when its I/O completes. A CPU that finds its own queue empty
+// steals the next job of the CPU with the longest ready queue.
+//
+// Every tick follows the step order of the single-CPU loops, with the CPUs
+// handled in index order, so a one-CPU run gives the same results as
+// schedule_sjf(), schedule_rr() and run_mlfq_scheduler().
+//
+// With config->host_threads > 1 the per-CPU steps of a tick (MLFQ boosts,
+// preemption, dispatch from the CPU's own queue, running the job) are split
+// over a pool of host threads owning contiguous CPU ranges, with a barrier
+// between steps. With --rng keyed an I/O draw is a pure function of the
+// PID and the tick, so each thread also draws IO_request() for its running
+// jobs and keeps and checks the I/O jobs of its own CPUs. The other
+// generators are one ordered stream: their draws stay on the main thread
+// in CPU order, over one shared I/O queue that each thread's jobs are
+// spliced onto in thread order (so CPU order). Arrivals and stealing stay
+// on the main thread; they read indexed heaps of the CPUs by load and by
+// queued jobs that only re-sort the CPUs whose counts changed, so placing
+// or stealing a job costs O(log CPUs) instead of a scan over every CPU and
+// level. Results do not depend on the number of host threads.
+//
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "include/scheduler.h"
+#include "include/scheduler_mlfq.h"
+#include "include/arrival_cursor.h"
+#include "include/queue.h"
+#include "include/clock.h"
+#include "include/utils.h"
+
+typedef enum {
+    SMP_JOB_NEW = 0,
+    SMP_JOB_READY,
+    SMP_JOB_RUNNING,
+    SMP_JOB_IO,
+    SMP_JOB_DONE
+} SmpJobState;
+
+typedef struct {
+    Job *job;
+    SimTime remaining_time;
+    int time_slice_used;
+    int level;                  // MLFQ level (0 for SJF/RR)
+    int cpu;                    // CPU the job is queued on or last ran on
+    SmpJobState state;
+    SimTime since;              // First tick of the current READY/IO span, charged when the job leaves
+    QueueNode link;             // Ready/I/O queue link
+} SmpJobContext;
+
+#define SMP_CACHE_LINE 64
+
+// Each host thread gets at least this many CPUs; below that the two
+// barriers per tick cost more than the per-CPU work they spread
+#define SMP_MIN_CPUS_PER_THREAD 16
+
+// Written by one host thread per tick; aligned so CPUs handled by different
+// threads never share a cache line
+typedef struct {
+    _Alignas(SMP_CACHE_LINE) Queue *ready[MLFQ_NUM_QUEUES];   // SJF and RR only use ready[0]
+    SmpJobContext *running;
+    int queued;                 // Jobs in the ready queues, all levels
+    int io_drawn;               // IO_request() result drawn for the running job this tick
+    int owner;                  // Host thread (worker index) whose range holds this CPU
+    int load_changed;           // Listed in the owner's changed_cpus since the heaps were updated
+    int steal_slot;             // Position in the steal heap
+    int place_slot;             // Position in the placement heap
+    int steal_key;              // queued as the steal heap last saw it
+    int place_key;              // queued + running as the placement heap last saw it
+    CpuStats stats;
+} SmpCpu;
+
+// Indexed binary heap of CPU numbers. The steal heap keeps the CPU with the
+// most queued jobs on top, the placement heap the CPU with the fewest jobs
+// (queued plus running); both break ties by the lower CPU number. Heaps
+// order CPUs by keys copied from the counts one CPU at a time, so each
+// update starts from a valid heap even when many counts changed.
+typedef struct {
+    int *cpus;
+    int by_load;                // 0: steal heap, 1: placement heap
+} SmpCpuHeap;
+
+// Per-CPU steps of a tick, run over a range of CPUs by each host thread
+typedef enum {
+    SMP_STEP_BOOST,
+    SMP_STEP_DISPATCH,
+    SMP_STEP_RUN,
+    SMP_STEP_STOP
+} SmpStep;
+
+typedef struct SmpMachine SmpMachine;
+
+// One host thread and its CPU range. Lists of CPUs are kept in the machine's
+// per-CPU arrays at [first_cpu, first_cpu + count), so threads never share
+// a list; the main thread reads them once the step is over.
+typedef struct {
+    _Alignas(SMP_CACHE_LINE) SmpMachine *machine;
+    int first_cpu;
+    int end_cpu;
+    Queue *io;                  // Jobs the range's CPUs sent to I/O, in CPU order per tick. With
+                                // keyed draws they stay here and the thread checks them; the
+                                // ordered generators move them to the shared queue every tick.
+    QueueNode **io_done;        // Keyed draws: jobs of io completing I/O this tick
+    int io_done_capacity;
+    int completed;              // Jobs that completed this tick
+    int idle_count;             // CPUs still idle after dispatch, in idle_cpus
+    int changed_count;          // CPUs whose queued count or running job changed, in changed_cpus
+    pthread_t thread;
+} SmpWorker;
+
+struct SmpMachine {
+    SimContext *sim;                // Clock and I/O draws, used by the main thread only
+    const SchedulerConfig *config;
+    SchedulerPolicy policy;
+    int levels;
+    SmpJobContext *contexts;
+    SmpCpu *cpus;
+    int cpu_count;
+    Queue *io_queue;
+    QueueNode **io_completions;     // Jobs finishing I/O in one tick
+    DrawBatch draws;                // Batched I/O draws, room for every job and every CPU
+    int keyed_draws;                // IO_request() is order-free (SIM_RNG_KEYED): draw it on the workers
+    int completed;
+    SmpCpuHeap steal_heap;
+    SmpCpuHeap place_heap;
+    int *idle_cpus;                 // Per-worker lists, see SmpWorker
+    int *changed_cpus;
+
+    // Host thread pool; workers[0] is the main thread
+    SmpWorker *workers;
+    int worker_count;               // Threads in use, including the main thread
+    int workers_allocated;
+    pthread_barrier_t barrier;
+    pthread_mutex_t gate_lock;      // Holds workers back until the pool size is known
+    pthread_cond_t gate_cond;
+    int gate_ready;                 // gate_lock and gate_cond are initialized
+    int gate_open;
+    SmpStep step;                   // Set by the main thread before the start barrier
+    SimTime now;
+};
+
+static SmpJobContext *context_of(QueueNode *node) {
+    if (node == NULL) {
+        return NULL;
+    }
+    return queue_node_container(node, SmpJobContext, link);
+}
+
+static int time_slice_of(const SmpMachine *machine, const SmpJobContext *ctx) {
+    if (machine->policy == SCHED_POLICY_RR) {
+        return machine->config->time_quantum;
+    }
+    return machine->config->mlfq_time_slice[ctx->level];
+}
+
+static int *heap_slot(SmpMachine *machine, const SmpCpuHeap *heap, int cpu) {
+    return heap->by_load ? &machine->cpus[cpu].place_slot : &machine->cpus[cpu].steal_slot;
+}
+
+static int cpu_before(const SmpMachine *machine, const SmpCpuHeap *heap, int a, int b) {
+    const SmpCpu *ca = &machine->cpus[a];
+    const SmpCpu *cb = &machine->cpus[b];
+    if (heap->by_load) {
+        if (ca->place_key != cb->place_key) {
+            return ca->place_key < cb->place_key;
+        }
+    } else if (ca->steal_key != cb->steal_key) {
+        return ca->steal_key > cb->steal_key;
+    }
+    return a < b;
+}
+
+static void heap_place(SmpMachine *machine, SmpCpuHeap *heap, int index, int cpu) {
+    heap->cpus[index] = cpu;
+    *heap_slot(machine, heap, cpu) = index;
+}
+
+// Move cpu to its place after its key changed
+static void heap_update(SmpMachine *machine, SmpCpuHeap *heap, int cpu) {
+    int index = *heap_slot(machine, heap, cpu);
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!cpu_before(machine, heap, cpu, heap->cpus[parent])) {
+            break;
+        }
+        heap_place(machine, heap, index, heap->cpus[parent]);
+        index = parent;
+    }
+    while (1) {
+        int child = 2 * index + 1;
+        if (child >= machine->cpu_count) {
+            break;
+        }
+        if (child + 1 < machine->cpu_count && cpu_before(machine, heap, heap->cpus[child + 1], heap->cpus[child])) {
+            child++;
+        }
+        if (!cpu_before(machine, heap, heap->cpus[child], cpu)) {
+            break;
+        }
+        heap_place(machine, heap, index, heap->cpus[child]);
+        index = child;
+    }
+    heap_place(machine, heap, index, cpu);
+}
+
+// Every CPU starts idle and empty, so CPU order is already a valid heap
+static int init_cpu_heap(SmpMachine *machine, SmpCpuHeap *heap, int by_load) {
+    heap->by_load = by_load;
+    heap->cpus = (int*)malloc(sizeof(int) * machine->cpu_count);
+    if (heap->cpus == NULL) {
+        return -1;
+    }
+    for (int cpu = 0; cpu < machine->cpu_count; cpu++) {
+        heap_place(machine, heap, cpu, cpu);
+    }
+    return 0;
+}
+
+// Record that a CPU's queued count or running job changed. Only the thread
+// owning the CPU (or the main thread between steps) calls this, and it
+// writes to that thread's list.
+static void note_load_change(SmpMachine *machine, int cpu) {
+    SmpCpu *core = &machine->cpus[cpu];
+    if (!core->load_changed) {
+        SmpWorker *owner = &machine->workers[core->owner];
+        core->load_changed = 1;
+        machine->changed_cpus[owner->first_cpu + owner->changed_count++] = cpu;
+    }
+}
+
+// Re-sort the CPUs listed since the last call (main thread, between steps)
+static void update_cpu_heaps(SmpMachine *machine) {
+    for (int w = 0; w < machine->worker_count; w++) {
+        SmpWorker *worker = &machine->workers[w];
+        for (int i = 0; i < worker->changed_count; i++) {
+            int cpu = machine->changed_cpus[worker->first_cpu + i];
+            SmpCpu *core = &machine->cpus[cpu];
+            core->steal_key = core->queued;
+            heap_update(machine, &machine->steal_heap, cpu);
+            core->place_key = core->queued + (core->running != NULL);
+            heap_update(machine, &machine->place_heap, cpu);
+            core->load_changed = 0;
+        }
+        worker->changed_count = 0;
+    }
+}
+
+static void make_ready(SmpMachine *machine, SmpJobContext *ctx, SimTime since) {
+    ctx->state = SMP_JOB_READY;
+    ctx->since = since;
+    ctx->time_slice_used = 0;
+    enqueue_node(machine->cpus[ctx->cpu].ready[ctx->level], &ctx->link, ctx->job, ctx->remaining_time);
+    machine->cpus[ctx->cpu].queued++;
+    note_load_change(machine, ctx->cpu);
+}
+
+// New jobs go to the CPU with the fewest jobs (queued plus running)
+static int least_loaded_cpu(SmpMachine *machine) {
+    update_cpu_heaps(machine);
+    return machine->place_heap.cpus[0];
+}
+
+// SJF/RR count every IO_complete() call as a tick of sleep, MLFQ only the
+// ticks the job is still in I/O after the check
+static void charge_io(const SmpMachine *machine, SmpJobContext *ctx, SimTime now) {
+    SimTime checks = (machine->policy == SCHED_POLICY_MLFQ) ? now - ctx->since : now + 1 - ctx->since;
+    sleep_span(ctx->job, checks);
+}
+
+// Jobs done with I/O return to the CPU they last ran on, in queue order;
+// RR breaks ties between simultaneous completions by PID
+static void finish_io(SmpMachine *machine, QueueNode **done, int count, SimTime now) {
+    if (machine->policy == SCHED_POLICY_RR) {
+        sort_nodes_by_pid(done, count);
+    }
+    for (int i = 0; i < count; i++) {
+        make_ready(machine, context_of(done[i]), now);
+    }
+}
+
+// Ordered generators: one shared I/O queue, drawn in queue order
+static void process_io(SmpMachine *machine, SimTime now) {
+    int pending = queue_size(machine->io_queue);
+    int completed_count = 0;
+    QueueNode **nodes = machine->io_completions;  // Compacted in place to the completed jobs
+    for (int i = 0; i < pending; i++) {
+        nodes[i] = dequeue_node(machine->io_queue);
+        machine->draws.pids[i] = nodes[i]->job->PID;
+    }
+    IO_complete_batch(machine->sim, &machine->draws, pending);
+    for (int i = 0; i < pending; i++) {
+        SmpJobContext *ctx = context_of(nodes[i]);
+        if (machine->draws.outcomes[i]) {
+            charge_io(machine, ctx, now);
+            machine->io_completions[completed_count++] = &ctx->link;
+        } else {
+            enqueue_node(machine->io_queue, &ctx->link, ctx->job, ctx->remaining_time);
+        }
+    }
+    finish_io(machine, machine->io_completions, completed_count, now);
+}
+
+// Keyed draws: each thread checks the I/O jobs of its own CPUs. A job
+// returns to the CPU it ran on, which is in the same range, and the
+// thread's queue keeps the shared queue's order for every CPU, so each
+// ready queue receives the same jobs in the same order as with
+// process_io(). The caller has made io_done large enough.
+static void process_worker_io(SmpMachine *machine, SmpWorker *worker, SimTime now) {
+    int pending = queue_size(worker->io);
+    int done = 0;
+    for (int i = 0; i < pending; i++) {
+        SmpJobContext *ctx = context_of(dequeue_node(worker->io));
+        if (IO_complete(machine->sim, ctx->job->PID)) {
+            charge_io(machine, ctx, now);
+            worker->io_done[done++] = &ctx->link;
+        } else {
+            enqueue_node(worker->io, &ctx->link, ctx->job, ctx->remaining_time);
+        }
+    }
+    finish_io(machine, worker->io_done, done, now);
+}
+
+// Grow every thread's io_done to its I/O queue (main thread, before the
+// step that calls process_worker_io()). Returns -1 if out of memory.
+static int reserve_worker_io(SmpMachine *machine) {
+    for (int w = 0; w < machine->worker_count; w++) {
+        SmpWorker *worker = &machine->workers[w];
+        int pending = queue_size(worker->io);
+        if (pending <= worker->io_done_capacity) {
+            continue;
+        }
+        int capacity = worker->io_done_capacity > 0 ? worker->io_done_capacity : 16;
+        while (capacity < pending) {
+            capacity *= 2;
+        }
+        QueueNode **io_done = (QueueNode**)realloc(worker->io_done, sizeof(QueueNode*) * capacity);
+        if (io_done == NULL) {
+            return -1;
+        }
+        worker->io_done = io_done;
+        worker->io_done_capacity = capacity;
+    }
+    return 0;
+}
+
+// Rule 5 on one CPU: queued jobs move to level 0 in order, a running job
+// below level 0 starts a fresh slice at level 0
+static void boost_priorities(SmpMachine *machine, int cpu) {
+    SmpCpu *core = &machine->cpus[cpu];
+    for (int level = 1; level < machine->levels; level++) {
+        queue_splice(core->ready[0], core->ready[level]);
+    }
+    if (core->running != NULL && core->running->level > 0) {
+        core->running->level = 0;
+        core->running->time_slice_used = 0;
+    }
+}
+
+// Jobs leave the CPU at the top of the tick: SJF preemption, RR slice expiry
+static void preempt(SmpMachine *machine, int cpu, SimTime now) {
+    SmpCpu *core = &machine->cpus[cpu];
+    SmpJobContext *current = core->running;
+    if (current == NULL) {
+        return;
+    }
+
+    int leave = 0;
+    if (machine->policy == SCHED_POLICY_SJF) {
+        SmpJobContext *candidate = context_of(peek_node(core->ready[0]));
+        leave = (candidate != NULL && candidate->remaining_time < current->remaining_time);
+    } else if (machine->policy == SCHED_POLICY_RR) {
+        leave = (current->time_slice_used >= machine->config->time_quantum);
+    }
+
+    if (leave) {
+        core->running = NULL;
+        make_ready(machine, current, now);
+    }
+}
+
+// Next job of a CPU's ready queues (highest MLFQ level first)
+static SmpJobContext *take_next(SmpMachine *machine, int cpu, int *level) {
+    SmpCpu *core = &machine->cpus[cpu];
+    if (core->queued == 0) {
+        return NULL;
+    }
+    for (int l = 0; l < machine->levels; l++) {
+        SmpJobContext *ctx = context_of(dequeue_node(core->ready[l]));
+        if (ctx != NULL) {
+            *level = l;
+            core->queued--;
+            note_load_change(machine, cpu);
+            return ctx;
+        }
+    }
+    return NULL;
+}
+
+static void dispatch(SmpMachine *machine, int cpu, SmpJobContext *ctx, int level, SimTime now) {
+    wait_span(ctx->job, now - ctx->since);
+    ctx->state = SMP_JOB_RUNNING;
+    ctx->cpu = cpu;
+    ctx->level = level;
+    ctx->time_slice_used = 0;
+    machine->cpus[cpu].running = ctx;
+    machine->cpus[cpu].stats.dispatches++;
+    note_load_change(machine, cpu);
+}
+
+// An idle CPU first takes its own next job; CPUs left idle are listed for stealing
+static void dispatch_own(SmpMachine *machine, SmpWorker *worker, int cpu, SimTime now) {
+    int level;
+    if (machine->cpus[cpu].running == NULL) {
+        SmpJobContext *ctx = take_next(machine, cpu, &level);
+        if (ctx != NULL) {
+            dispatch(machine, cpu, ctx, level, now);
+        } else {
+            machine->idle_cpus[worker->first_cpu + worker->idle_count++] = cpu;
+        }
+    }
+}
+
+// CPUs still idle, in CPU order, steal from the CPU with the most queued
+// jobs (lowest index on ties)
+static void steal_for_idle_cpus(SmpMachine *machine, SimTime now) {
+    int level;
+    int exhausted = 0;
+    for (int w = 0; w < machine->worker_count; w++) {
+        SmpWorker *worker = &machine->workers[w];
+        int idle_count = worker->idle_count;
+        worker->idle_count = 0;
+        for (int i = 0; i < idle_count && !exhausted; i++) {
+            update_cpu_heaps(machine);
+            int victim = machine->steal_heap.cpus[0];
+            if (machine->cpus[victim].queued == 0) {
+                exhausted = 1;  // Nothing is queued anywhere
+                break;
+            }
+
+            int cpu = machine->idle_cpus[worker->first_cpu + i];
+            SmpJobContext *ctx = take_next(machine, victim, &level);
+            dispatch(machine, cpu, ctx, level, now);
+            machine->cpus[cpu].stats.steals++;
+        }
+    }
+}
+
+// Draw IO_request() for every running job that will not complete this tick,
+// in CPU order, as the single-CPU loops do after run(); one batch per tick.
+// Only for ordered generators: keyed draws are made by the workers in run_step().
+static void draw_io_requests(SmpMachine *machine) {
+    int count = 0;
+    for (int cpu = 0; cpu < machine->cpu_count; cpu++) {
+        SmpCpu *core = &machine->cpus[cpu];
+        if (core->running != NULL && core->running->remaining_time > 1) {
+            machine->draws.pids[count++] = core->running->job->PID;
+        }
+    }
+    IO_request_batch(machine->sim, &machine->draws, count);
+
+    int next = 0;
+    for (int cpu = 0; cpu < machine->cpu_count; cpu++) {
+        SmpCpu *core = &machine->cpus[cpu];
+        core->io_drawn = (core->running != NULL && core->running->remaining_time > 1) ? machine->draws.outcomes[next++] : 0;
+    }
+}
+
+// Run a CPU's job for one tick; it leaves the CPU when it completes, requests
+// I/O or (MLFQ) uses up its time slice and is demoted
+static void run_cpu(SmpMachine *machine, SmpWorker *worker, int cpu, SimTime now) {
+    SmpCpu *core = &machine->cpus[cpu];
+    SmpJobContext *ctx = core->running;
+
+    if (machine->keyed_draws) {
+        core->io_drawn = (ctx->remaining_time > 1) ? IO_request(machine->sim, ctx->job->PID) : 0;
+    }
+
+    run(ctx->job);
+    ctx->remaining_time--;
+    ctx->time_slice_used++;
+    core->stats.busy_ticks++;
+
+    if (ctx->remaining_time <= 0) {
+        ctx->state = SMP_JOB_DONE;
+        worker->completed++;
+        core->running = NULL;
+        note_load_change(machine, cpu);
+    } else if (core->io_drawn) {
+        ctx->state = SMP_JOB_IO;
+        ctx->since = now + 1;  // First I/O check is next tick
+        enqueue_node(worker->io, &ctx->link, ctx->job, ctx->remaining_time);
+        core->running = NULL;
+        note_load_change(machine, cpu);
+    } else if (machine->policy == SCHED_POLICY_MLFQ && ctx->time_slice_used >= time_slice_of(machine, ctx)) {
+        if (ctx->level < machine->levels - 1) {
+            ctx->level++;
+        }
+        core->running = NULL;
+        make_ready(machine, ctx, now + 1);
+    }
+}
+
+static void run_step(SmpMachine *machine, SmpStep step, SmpWorker *worker) {
+    if (step == SMP_STEP_DISPATCH && machine->keyed_draws) {
+        process_worker_io(machine, worker, machine->now);
+    }
+    for (int cpu = worker->first_cpu; cpu < worker->end_cpu; cpu++) {
+        if (step == SMP_STEP_BOOST) {
+            boost_priorities(machine, cpu);
+        } else if (step == SMP_STEP_DISPATCH) {
+            preempt(machine, cpu, machine->now);
+            dispatch_own(machine, worker, cpu, machine->now);
+        } else if (machine->cpus[cpu].running != NULL) {
+            run_cpu(machine, worker, cpu, machine->now);
+        }
+    }
+}
+
+// Count the completed jobs and, for ordered generators, hand the jobs each
+// thread sent to I/O to the shared queue in thread order (so CPU order)
+static void collect_run_results(SmpMachine *machine) {
+    for (int w = 0; w < machine->worker_count; w++) {
+        SmpWorker *worker = &machine->workers[w];
+        if (!machine->keyed_draws) {
+            queue_splice(machine->io_queue, worker->io);
+        }
+        machine->completed += worker->completed;
+        worker->completed = 0;
+    }
+}
+
+static void *smp_worker(void *arg) {
+    SmpWorker *worker = (SmpWorker*)arg;
+    SmpMachine *machine = worker->machine;
+
+    // Wait until the pool size is known and the barrier is ready
+    pthread_mutex_lock(&machine->gate_lock);
+    while (!machine->gate_open) {
+        pthread_cond_wait(&machine->gate_cond, &machine->gate_lock);
+    }
+    pthread_mutex_unlock(&machine->gate_lock);
+
+    while (1) {
+        pthread_barrier_wait(&machine->barrier);
+        if (machine->step == SMP_STEP_STOP) {
+            return NULL;
+        }
+        run_step(machine, machine->step, worker);
+        pthread_barrier_wait(&machine->barrier);
+    }
+}
+
+// Run one per-CPU step on every CPU; the main thread takes the first range
+static void run_parallel(SmpMachine *machine, SmpStep step, SimTime now) {
+    machine->now = now;
+    if (machine->worker_count <= 1) {
+        run_step(machine, step, &machine->workers[0]);
+        return;
+    }
+
+    machine->step = step;
+    pthread_barrier_wait(&machine->barrier);
+    run_step(machine, step, &machine->workers[0]);
+    pthread_barrier_wait(&machine->barrier);
+}
+
+// Start up to count - 1 host threads; the CPUs are split into contiguous
+// ranges over the threads that started and the main thread (workers[0],
+// which is all there is without a pool). Returns -1 if out of memory.
+static int start_workers(SmpMachine *machine, int count) {
+    if (count > machine->cpu_count / SMP_MIN_CPUS_PER_THREAD) {
+        count = machine->cpu_count / SMP_MIN_CPUS_PER_THREAD;
+    }
+    if (count < 1) {
+        count = 1;
+    }
+
+    machine->workers = (SmpWorker*)aligned_alloc(SMP_CACHE_LINE, sizeof(SmpWorker) * count);
+    if (machine->workers == NULL) {
+        return -1;
+    }
+    memset(machine->workers, 0, sizeof(SmpWorker) * count);
+    machine->workers_allocated = count;
+    for (int i = 0; i < count; i++) {
+        machine->workers[i].machine = machine;
+        machine->workers[i].io = create_queue(QUEUE_FIFO_RING);
+        if (machine->workers[i].io == NULL) {
+            return -1;
+        }
+    }
+    machine->workers[0].end_cpu = machine->cpu_count;
+    machine->worker_count = 1;
+    if (count == 1) {
+        return 0;
+    }
+
+    pthread_mutex_init(&machine->gate_lock, NULL);
+    pthread_cond_init(&machine->gate_cond, NULL);
+    machine->gate_open = 0;
+    machine->gate_ready = 1;
+
+    int started = 1;
+    for (int i = 1; i < count; i++) {
+        if (pthread_create(&machine->workers[i].thread, NULL, smp_worker, &machine->workers[i]) != 0) {
+            fprintf(stderr, "Multi-CPU engine: started %d of %d host threads\n", started, count);
+            break;
+        }
+        started++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        machine->workers[i].first_cpu = (int)((long)machine->cpu_count * i / started);
+        machine->workers[i].end_cpu = (int)((long)machine->cpu_count * (i + 1) / started);
+        for (int cpu = machine->workers[i].first_cpu; cpu < machine->workers[i].end_cpu; cpu++) {
+            machine->cpus[cpu].owner = i;
+        }
+    }
+    if (started > 1) {
+        pthread_barrier_init(&machine->barrier, NULL, started);
+    }
+    machine->worker_count = started;
+
+    pthread_mutex_lock(&machine->gate_lock);
+    machine->gate_open = 1;
+    pthread_cond_broadcast(&machine->gate_cond);
+    pthread_mutex_unlock(&machine->gate_lock);
+    return 0;
+}
+
+static void stop_workers(SmpMachine *machine) {
+    if (machine->worker_count > 1) {
+        machine->step = SMP_STEP_STOP;
+        pthread_barrier_wait(&machine->barrier);
+        for (int i = 1; i < machine->worker_count; i++) {
+            pthread_join(machine->workers[i].thread, NULL);
+        }
+        pthread_barrier_destroy(&machine->barrier);
+    }
+    if (machine->gate_ready) {
+        pthread_cond_destroy(&machine->gate_cond);
+        pthread_mutex_destroy(&machine->gate_lock);
+        machine->gate_ready = 0;
+    }
+    machine->worker_count = 1;
+}
+
+// Charge the open READY/IO spans of jobs still waiting when the loop ends
+static void flush_pending_spans(SmpMachine *machine, int count, SimTime now) {
+    for (int i = 0; i < count; i++) {
+        SmpJobContext *ctx = &machine->contexts[i];
+        if (ctx->state == SMP_JOB_READY) {
+            wait_span(ctx->job, now - ctx->since);
+        } else if (ctx->state == SMP_JOB_IO) {
+            sleep_span(ctx->job, now - ctx->since);
+        }
+    }
+}
+
+static void destroy_machine(SmpMachine *machine) {
+    if (machine->cpus != NULL) {
+        for (int cpu = 0; cpu < machine->cpu_count; cpu++) {
+            for (int level = 0; level < machine->levels; level++) {
+                if (machine->cpus[cpu].ready[level] != NULL) {
+                    destroy_queue(machine->cpus[cpu].ready[level]);
+                }
+            }
+        }
+    }
+    if (machine->io_queue != NULL) {
+        destroy_queue(machine->io_queue);
+    }
+    for (int i = 0; i < machine->workers_allocated; i++) {
+        if (machine->workers[i].io != NULL) {
+            destroy_queue(machine->workers[i].io);
+        }
+        free(machine->workers[i].io_done);
+    }
+    free(machine->workers);
+    free(machine->steal_heap.cpus);
+    free(machine->place_heap.cpus);
+    free(machine->idle_cpus);
+    free(machine->changed_cpus);
+    free(machine->cpus);
+    free(machine->contexts);
+    free(machine->io_completions);
+    free_draw_batch(&machine->draws);
+}
+
+void schedule_multicore(SimContext *sim, Job **jobs, int n, const SchedulerConfig *config, CpuReport *report) {
+    if (jobs == NULL || n <= 0 || config == NULL || report == NULL || config->cpus <= 0) {
+        return;
+    }
+
+    SmpMachine machine = { 0 };
+    machine.sim = sim;
+    machine.config = config;
+    machine.policy = config->policy;
+    machine.levels = (config->policy == SCHED_POLICY_MLFQ) ? MLFQ_NUM_QUEUES : 1;
+    machine.cpu_count = config->cpus;
+    machine.contexts = (SmpJobContext*)calloc(n, sizeof(SmpJobContext));
+    machine.cpus = (SmpCpu*)aligned_alloc(SMP_CACHE_LINE, sizeof(SmpCpu) * machine.cpu_count);
+    if (machine.cpus != NULL) {
+        memset(machine.cpus, 0, sizeof(SmpCpu) * machine.cpu_count);
+    }
+    machine.io_completions = (QueueNode**)malloc(sizeof(QueueNode*) * n);
+    int draws_ok = init_draw_batch(&machine.draws, n > machine.cpu_count ? n : machine.cpu_count) == 0;
+    machine.io_queue = create_queue(QUEUE_FIFO_RING);
+    machine.keyed_draws = (sim->rng.kind == SIM_RNG_KEYED);
+    machine.idle_cpus = (int*)malloc(sizeof(int) * machine.cpu_count);
+    machine.changed_cpus = (int*)malloc(sizeof(int) * machine.cpu_count);
+    report->per_cpu = (CpuStats*)calloc(machine.cpu_count, sizeof(CpuStats));
+
+    int ok = machine.contexts != NULL && machine.cpus != NULL && machine.io_completions != NULL &&
+             draws_ok && machine.io_queue != NULL && machine.idle_cpus != NULL &&
+             machine.changed_cpus != NULL && report->per_cpu != NULL;
+    ok = ok && init_cpu_heap(&machine, &machine.steal_heap, 0) == 0 &&
+         init_cpu_heap(&machine, &machine.place_heap, 1) == 0 &&
+         start_workers(&machine, config->host_threads) == 0;
+    // MLFQ levels are lists: a boost is then an O(1) splice per level
+    QueueType ready_type = (machine.policy == SCHED_POLICY_SJF) ? QUEUE_SJF_HEAP :
+                           (machine.policy == SCHED_POLICY_MLFQ) ? QUEUE_FIFO : QUEUE_FIFO_RING;
+    for (int cpu = 0; ok && cpu < machine.cpu_count; cpu++) {
+        for (int level = 0; ok && level < machine.levels; level++) {
+            machine.cpus[cpu].ready[level] = create_queue(ready_type);
+            ok = machine.cpus[cpu].ready[level] != NULL;
+        }
+    }
+    ArrivalCursor *arrivals = ok ? create_arrival_cursor(jobs, n, n) : NULL;
+    if (arrivals == NULL) {
+        fprintf(stderr, "Multi-CPU engine: failed to allocate simulation state\n");
+        stop_workers(&machine);
+        destroy_machine(&machine);
+        free(report->per_cpu);
+        report->per_cpu = NULL;
+        return;
+    }
+    report->cpus = machine.cpu_count;
+
+    for (int i = 0; i < n; i++) {
+        machine.contexts[i].job = jobs[i];
+        machine.contexts[i].remaining_time = jobs[i]->service;
+        machine.contexts[i].state = SMP_JOB_NEW;
+    }
+
+    init_clock(sim);
+    int boost_counter = 0;
+
+    while (machine.completed < n) {
+        SimTime now = current_clock(sim);
+
+        if (machine.policy == SCHED_POLICY_MLFQ && boost_counter >= config->mlfq_boost_interval) {
+            run_parallel(&machine, SMP_STEP_BOOST, now);
+            boost_counter = 0;
+        }
+
+        int arrived;
+        while ((arrived = arrival_cursor_next(arrivals, now)) >= 0) {
+            SmpJobContext *ctx = &machine.contexts[arrived];
+            ctx->cpu = least_loaded_cpu(&machine);
+            ctx->level = 0;
+            make_ready(&machine, ctx, now);
+        }
+
+        if (!machine.keyed_draws) {
+            process_io(&machine, now);
+        } else if (reserve_worker_io(&machine) != 0) {
+            fprintf(stderr, "Multi-CPU engine: out of memory, simulation stopped at tick %lld\n", now);
+            break;
+        }
+
+        run_parallel(&machine, SMP_STEP_DISPATCH, now);
+        steal_for_idle_cpus(&machine, now);
+
+        if (!machine.keyed_draws) {
+            draw_io_requests(&machine);
+        }
+        run_parallel(&machine, SMP_STEP_RUN, now);
+        collect_run_results(&machine);
+
+        next_tick(sim);
+        boost_counter++;
+
+        if (machine.completed >= n) {
+            break;
+        }
+
+        if (past_horizon(config, current_clock(sim))) {
+            break;
+        }
+    }
+
+    stop_workers(&machine);
+    flush_pending_spans(&machine, n, current_clock(sim));
+    report->total_time = current_clock(sim);
+    for (int cpu = 0; cpu < machine.cpu_count; cpu++) {
+        report->per_cpu[cpu] = machine.cpus[cpu].stats;
+    }
+
+    destroy_arrival_cursor(arrivals);
+    destroy_machine(&machine);
+}
@@ -0,0 +1,19 @@
+//
+// Simulation Context
+// Implementation File
+//
+
+#include <stddef.h>
+
+#include "include/sim_context.h"
+#include "include/clock.h"
+#include "include/utils.h"
+
+void init_sim_context(SimContext *sim, SimRngKind kind, unsigned int seed) {
+    if (sim == NULL) return;
+
+    init_clock(sim);
+    sim->rng.kind = kind;
+    os_srand(sim, seed);
+    sim->queue_stats = NULL;
+}
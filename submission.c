@@ -0,0 +1,157 @@
+//
+// Job Submission Queue
+// Implementation File
+//
+
+#include <stdlib.h>
+
+#include "include/submission.h"
+
+SubmissionQueue* create_submission_queue(int capacity) {
+    if (capacity < 0) {
+        return NULL;
+    }
+
+    SubmissionQueue *queue = (SubmissionQueue*)malloc(sizeof(SubmissionQueue));
+    if (queue == NULL) {
+        return NULL;
+    }
+
+    queue->accepted = (Job**)malloc(sizeof(Job*) * (capacity > 0 ? capacity : 1));
+    if (queue->accepted == NULL) {
+        free(queue);
+        return NULL;
+    }
+
+    atomic_init(&queue->stub.next, NULL);
+    queue->stub.job = NULL;
+    atomic_init(&queue->head, &queue->stub);
+    queue->tail = &queue->stub;
+    queue->capacity = capacity;
+    atomic_init(&queue->reserved, 0);
+    atomic_init(&queue->in_flight, 0);
+    atomic_init(&queue->closed, 0);
+    queue->accepted_count = 0;
+    return queue;
+}
+
+void destroy_submission_queue(SubmissionQueue *queue) {
+    if (queue == NULL) {
+        return;
+    }
+
+    SubmissionNode *node = queue->tail;
+    while (node != NULL) {
+        SubmissionNode *next = atomic_load(&node->next);
+        if (node != &queue->stub) {
+            free(node);
+        }
+        node = next;
+    }
+    free(queue->accepted);
+    free(queue);
+}
+
+// Append a node: one atomic exchange, then publish the link from the previous node
+static void push_node(SubmissionQueue *queue, SubmissionNode *node) {
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    SubmissionNode *prev = atomic_exchange_explicit(&queue->head, node, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+int submit_job(SubmissionQueue *queue, Job *job) {
+    if (queue == NULL || job == NULL) {
+        return -1;
+    }
+
+    // in_flight lets the consumer tell "closed and drained" from "a push is still landing"
+    atomic_fetch_add(&queue->in_flight, 1);
+    int result = -1;
+    if (!atomic_load(&queue->closed)) {
+        if (atomic_fetch_add(&queue->reserved, 1) < queue->capacity) {
+            SubmissionNode *node = (SubmissionNode*)malloc(sizeof(SubmissionNode));
+            if (node != NULL) {
+                node->job = job;
+                push_node(queue, node);
+                result = 0;
+            } else {
+                atomic_fetch_sub(&queue->reserved, 1);
+            }
+        } else {
+            atomic_fetch_sub(&queue->reserved, 1);
+        }
+    }
+    atomic_fetch_sub(&queue->in_flight, 1);
+    return result;
+}
+
+void close_submissions(SubmissionQueue *queue) {
+    if (queue != NULL) {
+        atomic_store(&queue->closed, 1);
+    }
+}
+
+// Record a taken job and free its node
+static Job* accept_node(SubmissionQueue *queue, SubmissionNode *node) {
+    Job *job = node->job;
+    free(node);
+    queue->accepted[queue->accepted_count++] = job;
+    return job;
+}
+
+Job* take_submission(SubmissionQueue *queue) {
+    if (queue == NULL) {
+        return NULL;
+    }
+
+    SubmissionNode *tail = queue->tail;
+    SubmissionNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    // Step over the stub
+    if (tail == &queue->stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
+
+    if (next != NULL) {
+        queue->tail = next;
+        return accept_node(queue, tail);
+    }
+
+    // tail is the last linked node. If a producer has already swapped in a
+    // newer head but not linked it yet, try again on a later tick.
+    if (tail != atomic_load_explicit(&queue->head, memory_order_acquire)) {
+        return NULL;
+    }
+
+    // Re-insert the stub so tail can be released
+    push_node(queue, &queue->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next != NULL) {
+        queue->tail = next;
+        return accept_node(queue, tail);
+    }
+    return NULL;
+}
+
+int submissions_finished(SubmissionQueue *queue) {
+    if (queue == NULL) {
+        return 1;
+    }
+    if (!atomic_load(&queue->closed) || atomic_load(&queue->in_flight) != 0) {
+        return 0;
+    }
+
+    // Closed with no push in progress: finished once the list is drained
+    SubmissionNode *tail = queue->tail;
+    SubmissionNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    return tail == &queue->stub && next == NULL;
+}
+
+int submission_capacity(const SubmissionQueue *queue) {
+    return queue == NULL ? 0 : queue->capacity;
+}
@@ -0,0 +1,319 @@
+//
+// Parameter Sweep
+// Implementation File
+//
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/sysinfo.h>
+
+#include "include/sweep.h"
+
+static const char *param_names[SWEEP_NUM_PARAMS] = {"quantum", "q0", "q1", "q2", "boost"};
+
+void init_sweep_grid(SweepGrid *grid) {
+    if (grid == NULL) return;
+    for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+        grid->count[p] = 0;
+        grid->values[p] = NULL;
+    }
+}
+
+void free_sweep_grid(SweepGrid *grid) {
+    if (grid == NULL) return;
+    for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+        free(grid->values[p]);
+    }
+    init_sweep_grid(grid);
+}
+
+static int add_value(SweepGrid *grid, int param, int value) {
+    if (grid->count[param] >= SWEEP_MAX_VALUES) {
+        fprintf(stderr, "Error: --sweep %s has more than %d values\n", param_names[param], SWEEP_MAX_VALUES);
+        return -1;
+    }
+    if (grid->values[param] == NULL) {
+        grid->values[param] = (int*)malloc(sizeof(int) * SWEEP_MAX_VALUES);
+        if (grid->values[param] == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return -1;
+        }
+    }
+    grid->values[param][grid->count[param]++] = value;
+    return 0;
+}
+
+// One list item: N or lo:hi[:step], digits only. Returns the number of
+// fields, or -1 if anything else is left over.
+static int parse_item(const char *item, long fields[3]) {
+    const char *p = item;
+    int count = 0;
+    while (1) {
+        if (!isdigit((unsigned char)*p) || count == 3) {
+            return -1;
+        }
+        char *end;
+        errno = 0;
+        fields[count++] = strtol(p, &end, 10);
+        if (errno != 0 || fields[count - 1] > INT_MAX) {
+            return -1;
+        }
+        if (*end == '\0') {
+            return count;
+        }
+        if (*end != ':') {
+            return -1;
+        }
+        p = end + 1;
+    }
+}
+
+static int add_item(SweepGrid *grid, int param, const char *item) {
+    long fields[3];
+    int count = parse_item(item, fields);
+    if (count < 0) {
+        fprintf(stderr, "Error: invalid --sweep value '%s'\n", item);
+        return -1;
+    }
+    long lo = fields[0];
+    long hi = (count >= 2) ? fields[1] : lo;
+    long step = (count == 3) ? fields[2] : 1;
+    if (lo <= 0 || hi < lo || step <= 0) {
+        fprintf(stderr, "Error: --sweep values must be positive and ranges increasing: '%s'\n", item);
+        return -1;
+    }
+
+    for (long value = lo; value <= hi; value += step) {
+        if (add_value(grid, param, (int)value) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int sweep_add_param(SweepGrid *grid, const char *spec) {
+    if (grid == NULL || spec == NULL) return -1;
+
+    const char *eq = strchr(spec, '=');
+    if (eq == NULL || eq[1] == '\0') {
+        fprintf(stderr, "Error: --sweep expects name=values, got '%s'\n", spec);
+        return -1;
+    }
+
+    int param = -1;
+    for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+        if (strlen(param_names[p]) == (size_t)(eq - spec) && strncmp(spec, param_names[p], eq - spec) == 0) {
+            param = p;
+        }
+    }
+    if (param < 0) {
+        fprintf(stderr, "Error: unknown --sweep parameter in '%s'. Expected quantum, q0, q1, q2 or boost.\n", spec);
+        return -1;
+    }
+    if (grid->count[param] > 0) {
+        fprintf(stderr, "Error: --sweep %s given more than once\n", param_names[param]);
+        return -1;
+    }
+
+    char item[64];
+    const char *start = eq + 1;
+    while (1) {
+        const char *end = strchr(start, ',');
+        size_t len = (end != NULL) ? (size_t)(end - start) : strlen(start);
+        if (len == 0 || len >= sizeof(item)) {
+            fprintf(stderr, "Error: invalid --sweep list '%s'\n", eq + 1);
+            return -1;
+        }
+        memcpy(item, start, len);
+        item[len] = '\0';
+        if (add_item(grid, param, item) != 0) {
+            return -1;
+        }
+        if (end == NULL) break;
+        start = end + 1;
+    }
+    return 0;
+}
+
+int sweep_grid_size(const SweepGrid *grid) {
+    long size = 1;
+    for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+        if (grid->count[p] > 0) {
+            size *= grid->count[p];
+            if (size > SWEEP_MAX_CONFIGS) {
+                return -1;
+            }
+        }
+    }
+    return (int)size;
+}
+
+// Configuration number index of the grid, the last parameter varying fastest
+static void grid_config(const SweepGrid *grid, const SchedulerConfig *base, int index, SchedulerConfig *out) {
+    *out = *base;
+    for (int p = SWEEP_NUM_PARAMS - 1; p >= 0; p--) {
+        if (grid->count[p] == 0) continue;
+        int value = grid->values[p][index % grid->count[p]];
+        index /= grid->count[p];
+        switch (p) {
+            case SWEEP_QUANTUM: out->time_quantum = value; break;
+            case SWEEP_Q0: out->mlfq_time_slice[0] = value; break;
+            case SWEEP_Q1: out->mlfq_time_slice[1] = value; break;
+            case SWEEP_Q2: out->mlfq_time_slice[2] = value; break;
+            case SWEEP_BOOST: out->mlfq_boost_interval = value; break;
+        }
+    }
+
+    // One host thread per run, no streaming
+    out->host_threads = 1;
+    out->submissions = NULL;
+}
+
+typedef struct {
+    Global_Info info;
+    int failed;
+} SweepResult;
+
+typedef struct {
+    Job **jobs;
+    int n;
+    const SchedulerConfig *base;
+    const SweepGrid *grid;
+    int configs;
+    atomic_int next;            // Next configuration to hand out
+    SweepResult *results;       // One per configuration
+} SweepShared;
+
+// Pool worker: runs configurations until the grid is exhausted. Each run gets
+// fresh copies of the jobs and its own context seeded like main(), so a row is
+// the same as a separate single run of that configuration.
+static void *sweep_worker(void *arg) {
+    SweepShared *shared = (SweepShared*)arg;
+
+    int index;
+    while ((index = atomic_fetch_add(&shared->next, 1)) < shared->configs) {
+        SchedulerConfig config;
+        grid_config(shared->grid, shared->base, index, &config);
+        SweepResult *result = &shared->results[index];
+        result->failed = simulate_summary(shared->jobs, shared->n, &config, 1, &result->info) != 0;
+    }
+    return NULL;
+}
+
+// Parameters shown in the report: the ones the policy reads
+static int param_applies(SchedulerPolicy policy, int param) {
+    if (param == SWEEP_QUANTUM) {
+        return policy == SCHED_POLICY_RR;
+    }
+    return policy == SCHED_POLICY_MLFQ;
+}
+
+static void print_sweep_report(const SweepShared *shared) {
+    SchedulerPolicy policy = shared->base->policy;
+
+    for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+        if (param_applies(policy, p)) printf("%-7s | ", param_names[p]);
+    }
+    printf("%-10s | %-6s | %-8s | %-8s | %-14s | %-9s | %-9s\n",
+           "Total time", "Jobs", "Shortest", "Longest", "Avg completion", "Avg ready", "Avg sleep");
+
+    for (int index = 0; index < shared->configs; index++) {
+        SchedulerConfig config;
+        grid_config(shared->grid, shared->base, index, &config);
+        int values[SWEEP_NUM_PARAMS] = {
+            config.time_quantum, config.mlfq_time_slice[0], config.mlfq_time_slice[1],
+            config.mlfq_time_slice[2], config.mlfq_boost_interval
+        };
+        for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+            if (param_applies(policy, p)) printf("%-7d | ", values[p]);
+        }
+
+        const SweepResult *result = &shared->results[index];
+        if (result->failed) {
+            printf("failed\n");
+            continue;
+        }
+        const Global_Info *info = &result->info;
+        printf("%-10lld | %-6d | %-8lld | %-8lld | %-14.2f | %-9.2f | %-9.2f\n",
+               info->total_simulate_time, info->total_number_of_job,
+               info->shortest_job_completion_time, info->longest_job_completion_time,
+               info->average_completion, info->average_ready, info->average_sleep);
+    }
+}
+
+int run_sweep(Job **jobs, int n, const SchedulerConfig *base, const SweepGrid *grid, int threads) {
+    if (jobs == NULL || n <= 0 || base == NULL || grid == NULL) {
+        fprintf(stderr, "Error: no jobs available for the sweep\n");
+        return -1;
+    }
+
+    for (int p = 0; p < SWEEP_NUM_PARAMS; p++) {
+        if (grid->count[p] > 0 && !param_applies(base->policy, p)) {
+            fprintf(stderr, "Error: --sweep %s does not apply to this policy\n", param_names[p]);
+            return -1;
+        }
+    }
+
+    int configs = sweep_grid_size(grid);
+    if (configs < 0) {
+        fprintf(stderr, "Error: the sweep exceeds %d configurations\n", SWEEP_MAX_CONFIGS);
+        return -1;
+    }
+
+    // Reject a bad base configuration once instead of failing every row
+    SchedulerConfig first;
+    grid_config(grid, base, 0, &first);
+    if (first.policy == SCHED_POLICY_RR && first.time_quantum <= 0) {
+        fprintf(stderr, "Error: round-robin requires a positive time quantum\n");
+        return -1;
+    }
+
+    SweepShared shared;
+    shared.jobs = jobs;
+    shared.n = n;
+    shared.base = base;
+    shared.grid = grid;
+    shared.configs = configs;
+    atomic_init(&shared.next, 0);
+    shared.results = (SweepResult*)calloc(configs, sizeof(SweepResult));
+    if (shared.results == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+
+    if (threads <= 0) {
+        threads = get_nprocs();
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+    if (threads > configs) {
+        threads = configs;
+    }
+    pthread_t *workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    int started = 0;
+    while (workers != NULL && started < threads &&
+           pthread_create(&workers[started], NULL, sweep_worker, &shared) == 0) {
+        started++;
+    }
+    if (started == 0) {
+        // No pool: run the whole grid on this thread
+        sweep_worker(&shared);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    printf("Swept %d configuration(s)\n", configs);
+    print_sweep_report(&shared);
+
+    free(shared.results);
+    return 0;
+}
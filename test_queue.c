@@ -4,11 +4,16 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <pthread.h>
 #include "../include/queue.h"
+#include "../include/submission.h"
+#include "../include/event_calendar.h"
+#include "../include/arrival_cursor.h"
 #include "../include/job.h"
+#include "../include/scheduler.h"
 
 // Helper function to create a simple job for testing
-Job* create_test_job(int pid, int arrival, int service, int priority) {
+Job* create_test_job(int pid, SimTime arrival, SimTime service, int priority) {
     Job *job = (Job*)malloc(sizeof(Job));
     if (job == NULL) {
         return NULL;
@@ -33,9 +38,9 @@ void test_fifo_queue() {
     Job *job2 = create_test_job(101, 1, 20, 0);
     Job *job3 = create_test_job(102, 2, 15, 0);
 
-    enqueue(queue, job1, job1->service);
-    enqueue(queue, job2, job2->service);
-    enqueue(queue, job3, job3->service);
+    enqueue(queue, job1, job1->service, NULL);
+    enqueue(queue, job2, job2->service, NULL);
+    enqueue(queue, job3, job3->service, NULL);
 
     printf("After enqueuing 3 jobs:\n");
     print_queue(queue);
@@ -73,10 +78,10 @@ void test_sjf_queue() {
     Job *job4 = create_test_job(103, 2, 10, 0);  // Same remaining time as job2
 
     // Enqueue in non-sorted order with different remaining times
-    enqueue(queue, job1, 20);
-    enqueue(queue, job2, 10);
-    enqueue(queue, job3, 15);
-    enqueue(queue, job4, 10);  // Same as job2, should come after due to higher PID
+    enqueue(queue, job1, 20, NULL);
+    enqueue(queue, job2, 10, NULL);
+    enqueue(queue, job3, 15, NULL);
+    enqueue(queue, job4, 10, NULL);  // Same as job2, should come after due to higher PID
 
     printf("After enqueuing 4 jobs (should be sorted by remaining time):\n");
     print_queue(queue);
@@ -84,7 +89,7 @@ void test_sjf_queue() {
     printf("\nDequeuing all jobs:\n");
     while (!is_empty(queue)) {
         Job *job = dequeue(queue);
-        printf("  Dequeued PID: %d, Service Time: %d\n", job->PID, job->service);
+        printf("  Dequeued PID: %d, Service Time: %lld\n", job->PID, job->service);
         free(job);
     }
 
@@ -105,10 +110,10 @@ void test_priority_queue() {
     Job *job4 = create_test_job(103, 2, 10, 0);  // Same priority as job2
 
     // Enqueue in non-sorted order
-    enqueue(queue, job1, job1->service);
-    enqueue(queue, job2, job2->service);
-    enqueue(queue, job3, job3->service);
-    enqueue(queue, job4, job4->service);
+    enqueue(queue, job1, job1->service, NULL);
+    enqueue(queue, job2, job2->service, NULL);
+    enqueue(queue, job3, job3->service, NULL);
+    enqueue(queue, job4, job4->service, NULL);
 
     printf("After enqueuing 4 jobs (should be sorted by priority):\n");
     print_queue(queue);
@@ -125,6 +130,72 @@ void test_priority_queue() {
     printf("Priority test passed!\n");
 }
 
+// Heap-backed queues must dequeue in exactly the same order as the list versions
+static void check_heap_matches_list(QueueType list_type, QueueType heap_type) {
+    Queue *list = create_queue(list_type);
+    Queue *heap = create_queue(heap_type);
+    Job *jobs[32];
+
+    for (int i = 0; i < 32; i++) {
+        // Deliberately produce repeated keys so the PID tie-break is exercised
+        jobs[i] = create_test_job(200 + (i * 7) % 32, i, 5 + (i * 13) % 9, (i * 5) % 4);
+        enqueue(list, jobs[i], jobs[i]->service, NULL);
+        enqueue(heap, jobs[i], jobs[i]->service, NULL);
+    }
+
+    // Move one job to the front in both queues
+    update_remaining_time(heap, jobs[20], 0);
+    update_remaining_time(list, jobs[20], 0);
+    remove_job(list, jobs[3]);
+    remove_job(heap, jobs[3]);
+
+    int mismatches = 0;
+    while (!is_empty(list)) {
+        Job *expected = dequeue(list);
+        Job *actual = dequeue(heap);
+        if (expected != actual) {
+            mismatches++;
+        }
+    }
+    printf("Heap order matches list order: %s\n", (mismatches == 0 && is_empty(heap)) ? "Yes (correct)" : "No (error)");
+
+    for (int i = 0; i < 32; i++) {
+        free(jobs[i]);
+    }
+    destroy_queue(list);
+    destroy_queue(heap);
+}
+
+void test_heap_queues() {
+    printf("\n=== Testing Heap-Backed Queues ===\n");
+
+    Queue *queue = create_queue(QUEUE_SJF_HEAP);
+    Job *job1 = create_test_job(100, 0, 20, 0);
+    Job *job2 = create_test_job(101, 1, 10, 0);
+    Job *job3 = create_test_job(102, 2, 15, 0);
+    Job *job4 = create_test_job(103, 2, 10, 0);
+
+    enqueue(queue, job1, 20, NULL);
+    enqueue(queue, job2, 10, NULL);
+    enqueue(queue, job3, 15, NULL);
+    enqueue(queue, job4, 10, NULL);
+    print_queue(queue);
+
+    printf("Find PID 102: %s\n", find_job_by_pid(queue, 102) == job3 ? "Found (correct)" : "Not found (error)");
+    printf("\nDequeuing all jobs:\n");
+    while (!is_empty(queue)) {
+        Job *job = dequeue(queue);
+        printf("  Dequeued PID: %d, Service Time: %lld\n", job->PID, job->service);
+        free(job);
+    }
+    destroy_queue(queue);
+
+    check_heap_matches_list(QUEUE_SJF, QUEUE_SJF_HEAP);
+    check_heap_matches_list(QUEUE_PRIORITY, QUEUE_PRIORITY_HEAP);
+
+    printf("Heap queue test passed!\n");
+}
+
 void test_remove_job() {
     printf("\n=== Testing Remove Job ===\n");
 
@@ -134,9 +205,9 @@ void test_remove_job() {
     Job *job2 = create_test_job(101, 1, 20, 0);
     Job *job3 = create_test_job(102, 2, 15, 0);
 
-    enqueue(queue, job1, job1->service);
-    enqueue(queue, job2, job2->service);
-    enqueue(queue, job3, job3->service);
+    enqueue(queue, job1, job1->service, NULL);
+    enqueue(queue, job2, job2->service, NULL);
+    enqueue(queue, job3, job3->service, NULL);
 
     printf("Original queue:\n");
     print_queue(queue);
@@ -174,9 +245,9 @@ void test_clear_queue() {
     Job *job2 = create_test_job(101, 1, 20, 0);
     Job *job3 = create_test_job(102, 2, 15, 0);
 
-    enqueue(queue, job1, job1->service);
-    enqueue(queue, job2, job2->service);
-    enqueue(queue, job3, job3->service);
+    enqueue(queue, job1, job1->service, NULL);
+    enqueue(queue, job2, job2->service, NULL);
+    enqueue(queue, job3, job3->service, NULL);
 
     printf("Queue before clear:\n");
     print_queue(queue);
@@ -206,9 +277,9 @@ void test_update_remaining_time() {
     Job *job2 = create_test_job(101, 1, 15, 0);
     Job *job3 = create_test_job(102, 2, 10, 0);
 
-    enqueue(queue, job1, 20);
-    enqueue(queue, job2, 15);
-    enqueue(queue, job3, 10);
+    enqueue(queue, job1, 20, NULL);
+    enqueue(queue, job2, 15, NULL);
+    enqueue(queue, job3, 10, NULL);
 
     printf("Original queue:\n");
     print_queue(queue);
@@ -218,8 +289,7 @@ void test_update_remaining_time() {
     update_remaining_time(queue, job2, 5);
     print_queue(queue);
 
-    printf("Note: The queue order doesn't change automatically.\n");
-    printf("For SJF, you would need to remove and re-enqueue to re-sort.\n");
+    printf("Front job after update: PID %d (should be 101)\n", peek(queue)->PID);
 
     while (!is_empty(queue)) {
         free(dequeue(queue));
@@ -229,6 +299,617 @@ void test_update_remaining_time() {
     printf("Update remaining time test passed!\n");
 }
 
+static int count_slabs(const Queue *queue) {
+    int count = 0;
+    for (const QueueNodeSlab *slab = queue->slabs; slab != NULL; slab = slab->next) {
+        count++;
+    }
+    return count;
+}
+
+void test_node_pool() {
+    printf("\n=== Testing Node Pool ===\n");
+
+    Queue *queue = create_queue(QUEUE_FIFO);
+    Job *jobs[10];
+    for (int i = 0; i < 10; i++) {
+        jobs[i] = create_test_job(300 + i, 0, 10, 0);
+        enqueue(queue, jobs[i], jobs[i]->service, NULL);
+    }
+    int slabs_before = count_slabs(queue);
+
+    // Rotate the queue many times, like an I/O queue does every tick
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 10; i++) {
+            Job *job = dequeue(queue);
+            enqueue(queue, job, job->service, NULL);
+        }
+    }
+    printf("Slabs after 10000 rotations: %d (should be %d)\n", count_slabs(queue), slabs_before);
+    printf("Front job after rotations: PID %d (should be 300)\n", peek(queue)->PID);
+
+    clear_queue(queue);
+    printf("Slabs after clear: %d (should be 0)\n", count_slabs(queue));
+
+    for (int i = 0; i < 10; i++) {
+        free(jobs[i]);
+    }
+    destroy_queue(queue);
+
+    printf("Node pool test passed!\n");
+}
+
+typedef struct {
+    int tag;
+    QueueNode link;
+} TestContext;
+
+void test_intrusive_nodes() {
+    printf("\n=== Testing Intrusive Nodes ===\n");
+
+    Queue *fifo = create_queue(QUEUE_FIFO);
+    Queue *heap = create_queue(QUEUE_SJF_HEAP);
+    TestContext contexts[3] = {{0}};
+    Job *jobs[3];
+
+    for (int i = 0; i < 3; i++) {
+        jobs[i] = create_test_job(400 + i, 0, 30 - i * 10, 0);
+        contexts[i].tag = i;
+        enqueue_node(fifo, &contexts[i].link, jobs[i], jobs[i]->service);
+    }
+    printf("Linked flag while queued: %d (should be 1)\n", contexts[1].link.linked);
+    printf("Slabs allocated: %d (should be 0)\n", count_slabs(fifo));
+
+    // Move every node from the FIFO into the heap without allocating
+    while (!is_empty(fifo)) {
+        TestContext *ctx = queue_node_container(dequeue_node(fifo), TestContext, link);
+        enqueue_node(heap, &ctx->link, jobs[ctx->tag], jobs[ctx->tag]->service);
+    }
+
+    TestContext *first = queue_node_container(peek_node(heap), TestContext, link);
+    printf("Heap front tag: %d (should be 2)\n", first->tag);
+
+    remove_job(heap, jobs[0]);
+    printf("Linked flag after removal: %d (should be 0)\n", contexts[0].link.linked);
+    clear_queue(heap);
+    printf("Linked flag after clear: %d (should be 0)\n", contexts[2].link.linked);
+
+    for (int i = 0; i < 3; i++) {
+        free(jobs[i]);
+    }
+    destroy_queue(fifo);
+    destroy_queue(heap);
+
+    printf("Intrusive node test passed!\n");
+}
+
+void test_handles() {
+    printf("\n=== Testing Handles ===\n");
+
+    Queue *list = create_queue(QUEUE_SJF);
+    Queue *heap = create_queue(QUEUE_SJF_HEAP);
+    Job *jobs[40];
+    QueueNode *list_handles[40];
+    QueueNode *heap_handles[40];
+
+    for (int i = 0; i < 40; i++) {
+        jobs[i] = create_test_job(500 + i, 0, 10 + (i * 17) % 50, 0);
+        enqueue(list, jobs[i], jobs[i]->service, &list_handles[i]);
+        enqueue(heap, jobs[i], jobs[i]->service, &heap_handles[i]);
+    }
+
+    // Decrease and increase keys through the handles, then drop a few jobs
+    for (int i = 0; i < 40; i += 3) {
+        int new_time = (i * 7) % 45;
+        reposition_node(list, list_handles[i], new_time);
+        reposition_node(heap, heap_handles[i], new_time);
+    }
+    for (int i = 1; i < 40; i += 5) {
+        remove_node(list, list_handles[i]);
+        remove_node(heap, heap_handles[i]);
+    }
+    printf("Sizes after removals: %d and %d (should be 32)\n", queue_size(list), queue_size(heap));
+
+    int mismatches = 0;
+    int last_time = -1;
+    while (!is_empty(list)) {
+        QueueNode *node = peek_node(list);
+        if (node->remaining_time < last_time) {
+            mismatches++;
+        }
+        last_time = node->remaining_time;
+        if (dequeue(list) != dequeue(heap)) {
+            mismatches++;
+        }
+    }
+    printf("List stays sorted and matches heap: %s\n", mismatches == 0 ? "Yes (correct)" : "No (error)");
+
+    for (int i = 0; i < 40; i++) {
+        free(jobs[i]);
+    }
+    destroy_queue(list);
+    destroy_queue(heap);
+
+    printf("Handle test passed!\n");
+}
+
+static int visit_count = 0;
+static int visit_order_ok = 1;
+static int last_visited_pid = 0;
+
+static void visit_job(Job *job) {
+    if (job->PID <= last_visited_pid) {
+        visit_order_ok = 0;
+    }
+    last_visited_pid = job->PID;
+    visit_count++;
+}
+
+void test_ring_queue() {
+    printf("\n=== Testing Ring Queue ===\n");
+
+    Queue *ring = create_queue(QUEUE_FIFO_RING);
+    Queue *list = create_queue(QUEUE_FIFO);
+    Job *jobs[100];
+    for (int i = 0; i < 100; i++) {
+        jobs[i] = create_test_job(600 + i, 0, 10, 0);
+    }
+
+    // Interleave enqueues and dequeues so the ring wraps around and grows
+    int next = 0;
+    int mismatches = 0;
+    for (int round = 0; round < 50; round++) {
+        for (int k = 0; k < 3 && next < 100; k++, next++) {
+            enqueue(ring, jobs[next], jobs[next]->service, NULL);
+            enqueue(list, jobs[next], jobs[next]->service, NULL);
+        }
+        if (dequeue(ring) != dequeue(list)) {
+            mismatches++;
+        }
+    }
+    remove_job(ring, jobs[80]);
+    remove_job(list, jobs[80]);
+    printf("Size after wrap/grow: %d (should be %d)\n", queue_size(ring), queue_size(list));
+    printf("Find PID 690: %s\n", find_job_by_pid(ring, 690) == jobs[90] ? "Found (correct)" : "Not found (error)");
+
+    visit_count = 0;
+    queue_for_each(ring, visit_job);
+    printf("Visited %d jobs in FIFO order: %s\n", visit_count, visit_order_ok ? "Yes (correct)" : "No (error)");
+
+    while (!is_empty(list)) {
+        if (dequeue(ring) != dequeue(list)) {
+            mismatches++;
+        }
+    }
+    printf("Ring order matches list order: %s\n", (mismatches == 0 && is_empty(ring)) ? "Yes (correct)" : "No (error)");
+
+    // Caller-owned nodes are handed back by dequeue_node()
+    TestContext context = {7, {0}};
+    enqueue_node(ring, &context.link, jobs[0], 5);
+    printf("Linked node rejected: %s\n", enqueue_node(ring, &context.link, jobs[2], 5) == -1 ? "Yes (correct)" : "No (error)");
+    QueueNode *handle = &context.link;
+    int status = enqueue(ring, jobs[1], 5, &handle);
+    printf("Ring enqueue succeeds without a handle: %s\n", (status == 0 && handle == NULL) ? "Yes (correct)" : "No (error)");
+    TestContext *back = queue_node_container(dequeue_node(ring), TestContext, link);
+    printf("Context tag from ring: %d (should be 7), linked: %d (should be 0)\n", back->tag, context.link.linked);
+
+    for (int i = 0; i < 100; i++) {
+        free(jobs[i]);
+    }
+    destroy_queue(ring);
+    destroy_queue(list);
+
+    printf("Ring queue test passed!\n");
+}
+
+void test_pid_index() {
+    printf("\n=== Testing PID Index ===\n");
+
+    Queue *queue = create_queue(QUEUE_FIFO_RING);
+    Job *jobs[1000];
+    for (int i = 0; i < 1000; i++) {
+        jobs[i] = create_test_job(i * 16, 0, 10, 0);  // Strided PIDs collide more often
+        enqueue(queue, jobs[i], jobs[i]->service, NULL);
+    }
+    queue_enable_pid_index(queue);
+
+    // Drop every other job, then check every lookup
+    for (int i = 0; i < 1000; i += 2) {
+        remove_job(queue, jobs[i]);
+    }
+    int errors = 0;
+    for (int i = 0; i < 1000; i++) {
+        Job *found = find_job_by_pid(queue, i * 16);
+        if (found != ((i % 2 == 0) ? NULL : jobs[i])) {
+            errors++;
+        }
+    }
+    printf("Lookups after removals: %s\n", errors == 0 ? "All correct" : "Errors (error)");
+
+    dequeue(queue);
+    printf("Dequeued PID still indexed: %s\n", find_job_by_pid(queue, 16) == NULL ? "No (correct)" : "Yes (error)");
+
+    PidIndex *index = create_pid_index(4);
+    printf("Duplicate insert detected: %s\n",
+           (pid_index_insert(index, 7, jobs[0]) == 0 && pid_index_insert(index, 7, jobs[1]) == 1) ? "Yes (correct)" : "No (error)");
+    destroy_pid_index(index);
+
+    // PIDs sharing their low 16 bits must not pile up in one probe run
+    index = create_pid_index(0);
+    for (int k = 1; k <= 4096; k++) {
+        pid_index_insert(index, k * 65536, jobs[0]);
+    }
+    int run = 0, longest_run = 0;
+    for (int i = 0; i < index->capacity; i++) {
+        run = (index->slots[i].value != NULL) ? run + 1 : 0;
+        if (run > longest_run) longest_run = run;
+    }
+    printf("Longest probe run for 4096 PIDs with stride 65536: %d (should be small)%s\n",
+           longest_run, longest_run < 64 ? "" : " (error)");
+    destroy_pid_index(index);
+
+    for (int i = 0; i < 1000; i++) {
+        free(jobs[i]);
+    }
+    destroy_queue(queue);
+
+    printf("PID index test passed!\n");
+}
+
+void test_splice_and_batch() {
+    printf("\n=== Testing Splice and Batch ===\n");
+
+    Job *jobs[60];
+    SimTime times[60];
+    for (int i = 0; i < 60; i++) {
+        jobs[i] = create_test_job(700 + i, 0, 1 + (i * 29) % 40, 0);
+        times[i] = jobs[i]->service;
+    }
+
+    // List FIFO splice: pooled nodes move together with their slabs
+    Queue *dst = create_queue(QUEUE_FIFO);
+    Queue *src = create_queue(QUEUE_FIFO);
+    for (int i = 0; i < 10; i++) {
+        enqueue(i < 5 ? dst : src, jobs[i], times[i], NULL);
+    }
+    queue_splice(dst, src);
+    int src_empty = is_empty(src) && src->slabs == NULL;
+    destroy_queue(src);
+    int in_order = 1;
+    for (int i = 0; i < 10; i++) {
+        if (dequeue(dst) != jobs[i]) {
+            in_order = 0;
+        }
+    }
+    printf("List splice keeps order: %s, source empty: %s\n",
+           in_order ? "Yes (correct)" : "No (error)", src_empty ? "Yes (correct)" : "No (error)");
+    destroy_queue(dst);
+
+    // Ring splice into an empty ring swaps buffers; into a non-empty ring appends
+    Queue *ring_dst = create_queue(QUEUE_FIFO_RING);
+    Queue *ring_src = create_queue(QUEUE_FIFO_RING);
+    enqueue_batch(ring_src, jobs, times, 20);
+    queue_splice(ring_dst, ring_src);
+    enqueue_batch(ring_src, jobs + 20, times + 20, 20);
+    queue_splice(ring_dst, ring_src);
+    in_order = is_empty(ring_src) && queue_size(ring_dst) == 40;
+    for (int i = 0; i < 40; i++) {
+        if (dequeue(ring_dst) != jobs[i]) {
+            in_order = 0;
+        }
+    }
+    printf("Ring splice keeps order: %s\n", in_order ? "Yes (correct)" : "No (error)");
+
+    // Wrapped rings: mirror pushes, pops and splices on list FIFOs
+    Queue *list_dst = create_queue(QUEUE_FIFO);
+    Queue *list_src = create_queue(QUEUE_FIFO);
+    queue_enable_pid_index(ring_dst);
+    int mismatches = 0;
+    unsigned int lcg = 12345;
+    for (int step = 0; step < 2000; step++) {
+        lcg = lcg * 1103515245u + 12345u;
+        int op = (int)((lcg >> 16) % 8);
+        Job *job = jobs[step % 60];
+        if (op < 4 && find_job_by_pid(ring_dst, job->PID) == NULL && queue_size(ring_src) + queue_size(ring_dst) < 60) {
+            int in_src = 0;
+            for (int i = 0; i < queue_size(ring_src); i++) {
+                in_src |= ring_src->ring[(ring_src->ring_head + i) & (ring_src->ring_capacity - 1)].job == job;
+            }
+            if (!in_src) {
+                enqueue(op < 3 ? ring_src : ring_dst, job, job->service, NULL);
+                enqueue(op < 3 ? list_src : list_dst, job, job->service, NULL);
+            }
+        } else if (op == 4) {
+            mismatches += dequeue(ring_src) != dequeue(list_src);
+        } else if (op < 7) {
+            mismatches += dequeue(ring_dst) != dequeue(list_dst);
+        } else {
+            queue_splice(ring_dst, ring_src);
+            queue_splice(list_dst, list_src);
+            mismatches += !is_empty(ring_src);
+        }
+    }
+    while (!is_empty(list_dst)) {
+        Job *job = dequeue(list_dst);
+        mismatches += find_job_by_pid(ring_dst, job->PID) != job;
+        mismatches += dequeue(ring_dst) != job;
+    }
+    printf("Wrapped ring splices match list FIFOs: %s\n",
+           (mismatches == 0 && is_empty(ring_dst)) ? "Yes (correct)" : "No (error)");
+    destroy_queue(list_dst);
+    destroy_queue(list_src);
+    destroy_queue(ring_dst);
+    destroy_queue(ring_src);
+
+    // Batch into a heap must give the same order as one-by-one enqueue
+    Queue *batched = create_queue(QUEUE_SJF_HEAP);
+    Queue *single = create_queue(QUEUE_SJF_HEAP);
+    enqueue_batch(batched, jobs, times, 10);          // Heapify path (empty heap)
+    enqueue_batch(batched, jobs + 10, times + 10, 5); // Sift-up path
+    enqueue_batch(batched, jobs + 15, times + 15, 45);
+    for (int i = 0; i < 60; i++) {
+        enqueue(single, jobs[i], times[i], NULL);
+    }
+    mismatches = 0;
+    while (!is_empty(single)) {
+        if (dequeue(single) != dequeue(batched)) {
+            mismatches++;
+        }
+    }
+    printf("Heap batch matches single enqueues: %s\n", mismatches == 0 ? "Yes (correct)" : "No (error)");
+    destroy_queue(batched);
+    destroy_queue(single);
+
+    // Batch of caller-owned nodes
+    TestContext contexts[4] = {{0}};
+    QueueNode *nodes[4];
+    for (int i = 0; i < 4; i++) {
+        contexts[i].tag = i;
+        contexts[i].link.job = jobs[i];
+        contexts[i].link.remaining_time = 10 - i;
+        nodes[i] = &contexts[i].link;
+    }
+    Queue *heap = create_queue(QUEUE_SJF_HEAP);
+    enqueue_nodes(heap, nodes, 4);
+    TestContext *front = queue_node_container(peek_node(heap), TestContext, link);
+    printf("Node batch front tag: %d (should be 3)\n", front->tag);
+    destroy_queue(heap);
+
+    // In-place PID sort of more completions than fit in qsort's stack buffer
+    enum { SORT_COUNT = 300 };
+    Job sort_jobs[SORT_COUNT];
+    QueueNode sort_links[SORT_COUNT];
+    QueueNode *sorted[SORT_COUNT];
+    for (int i = 0; i < SORT_COUNT; i++) {
+        sort_jobs[i].PID = (i * 7919) % SORT_COUNT + 1;
+        sort_links[i].job = &sort_jobs[i];
+        sorted[i] = &sort_links[i];
+    }
+    sort_nodes_by_pid(sorted, SORT_COUNT);
+    mismatches = 0;
+    for (int i = 0; i < SORT_COUNT; i++) {
+        mismatches += sorted[i]->job->PID != i + 1;
+    }
+    printf("Nodes sorted by PID: %s\n", mismatches == 0 ? "Yes (correct)" : "No (error)");
+
+    for (int i = 0; i < 60; i++) {
+        free(jobs[i]);
+    }
+
+    printf("Splice and batch test passed!\n");
+}
+
+void test_queue_stats() {
+    printf("\n=== Testing Queue Stats ===\n");
+
+    Job *jobs[8];
+    for (int i = 0; i < 8; i++) {
+        jobs[i] = create_test_job(i + 1, 0, 10, 0);
+    }
+
+    Queue *queue = create_queue(QUEUE_SJF);
+    printf("Stats off by default: %s\n", queue_get_stats(queue) == NULL ? "Yes (correct)" : "No (error)");
+    queue_enable_stats(queue);
+
+    // Ascending remaining times: every insert walks past all queued nodes
+    for (int i = 0; i < 4; i++) {
+        enqueue(queue, jobs[i], i + 1, NULL);
+    }
+    dequeue(queue);
+    remove_job(queue, jobs[3]);  // Found after passing two nodes
+
+    const QueueStats *stats = queue_get_stats(queue);
+    printf("Enqueues/dequeues/removals: %lu/%lu/%lu (should be 4/1/1)\n",
+           stats->enqueues, stats->dequeues, stats->removals);
+    printf("Insert steps: %lu (should be 6)\n", stats->insert_steps);
+    printf("Remove steps: %lu (should be 2)\n", stats->remove_steps);
+    printf("Max depth: %d (should be 4)\n", stats->max_depth);
+    printf("Average depth: %.2f (should be 2.50)\n", (double)stats->depth_sum / stats->depth_samples);
+    destroy_queue(queue);
+
+    Queue *heap = create_queue(QUEUE_SJF_HEAP);
+    queue_enable_stats(heap);
+    for (int i = 0; i < 8; i++) {
+        enqueue(heap, jobs[i], 8 - i, NULL);  // Descending: each insert sifts to the root
+    }
+    printf("Heap insert steps: %lu (should be 13)\n", queue_get_stats(heap)->insert_steps);
+    destroy_queue(heap);
+
+    for (int i = 0; i < 8; i++) {
+        free(jobs[i]);
+    }
+
+    printf("Queue stats test passed!\n");
+}
+
+void test_event_calendar() {
+    printf("\n=== Testing Event Calendar ===\n");
+
+    EventCalendar *calendar = create_event_calendar(0);
+
+    // Insert out of order; expect (time, type, order) order back
+    int times[] = {5, 3, 5, 3, 9, 0, 5, 3};
+    EventType types[] = {EVENT_IO_DONE, EVENT_ARRIVAL, EVENT_BURST_END, EVENT_ARRIVAL,
+                         EVENT_QUANTUM_EXPIRY, EVENT_ARRIVAL, EVENT_IO_DONE, EVENT_BOOST};
+    long orders[] = {7, 2, 0, 1, 0, 0, 4, 0};
+    for (int i = 0; i < 8; i++) {
+        Event event = { times[i], types[i], orders[i], i, 0 };
+        schedule_event(calendar, event);
+    }
+    // Grow past the initial capacity
+    for (int i = 0; i < 100; i++) {
+        Event event = { 1000 + (i * 37) % 100, EVENT_ARRIVAL, 0, -1, 0 };
+        schedule_event(calendar, event);
+    }
+
+    int expected[] = {5, 7, 3, 1, 2, 6, 0, 4};
+    int errors = 0;
+    printf("Next event time: %lld (should be 0)\n", next_event_time(calendar));
+    for (int i = 0; i < 8; i++) {
+        Event event;
+        if (!next_event(calendar, &event) || event.target != expected[i]) {
+            errors++;
+        }
+    }
+    printf("Same-tick ordering: %s\n", errors == 0 ? "Correct" : "Wrong (error)");
+
+    int last = -1;
+    errors = 0;
+    Event event;
+    while (next_event(calendar, &event)) {
+        if (event.time < last) {
+            errors++;
+        }
+        last = event.time;
+    }
+    printf("Times non-decreasing: %s\n", errors == 0 ? "Yes (correct)" : "No (error)");
+    printf("Empty after draining: %s\n", event_calendar_size(calendar) == 0 ? "Yes (correct)" : "No (error)");
+    destroy_event_calendar(calendar);
+
+    printf("Event calendar test passed!\n");
+}
+
+void test_arrival_cursor() {
+    printf("\n=== Testing Arrival Cursor ===\n");
+
+    // Shuffled (arrival, PID) pairs, including large values, an arrival past
+    // 2^32 and a negative PID
+    int pids[] = {7, 3, 100000, -2, 5, 70000, 1, 4};
+    SimTime arrivals[] = {5, 0, 5, 0, 5000000000LL, 5, 0, 70000};
+    Job *jobs[8];
+    for (int i = 0; i < 8; i++) {
+        jobs[i] = create_test_job(pids[i], arrivals[i], 1, 0);
+    }
+
+    ArrivalCursor *cursor = create_arrival_cursor(jobs, 8, 10);
+    int expected[] = {3, 6, 1, 0, 5, 2, 7, 4};
+    int errors = 0;
+    for (int i = 0; i < 8; i++) {
+        if (cursor->order[i] != expected[i]) {
+            errors++;
+        }
+    }
+    printf("Radix order: %s\n", errors == 0 ? "Correct" : "Wrong (error)");
+
+    // Hand out everything that has arrived by tick 5
+    int handed = 0;
+    while (arrival_cursor_next(cursor, 5) >= 0) {
+        handed++;
+    }
+    printf("Arrived by tick 5: %d (should be 6)\n", handed);
+    printf("Next arrival: %lld (should be 70000)\n", arrival_cursor_peek_time(cursor));
+
+    // A submitted job is placed among the entries not handed out yet
+    Job *submitted = create_test_job(9, 100, 1, 0);
+    int index = arrival_cursor_insert(cursor, submitted);
+    printf("Inserted index: %d (should be 8)\n", index);
+    printf("Next arrival after insert: %lld (should be 100)\n", arrival_cursor_peek_time(cursor));
+    printf("Pending: %d (should be 3)\n", arrival_cursor_pending(cursor));
+
+    destroy_arrival_cursor(cursor);
+    free(submitted);
+    for (int i = 0; i < 8; i++) {
+        free(jobs[i]);
+    }
+
+    printf("Arrival cursor test passed!\n");
+}
+
+#define SUBMIT_PRODUCERS 4
+#define SUBMIT_PER_PRODUCER 500
+
+typedef struct {
+    SubmissionQueue *queue;
+    Job **jobs;
+} SubmitArgs;
+
+static void *submit_producer(void *arg) {
+    SubmitArgs *args = (SubmitArgs*)arg;
+    for (int i = 0; i < SUBMIT_PER_PRODUCER; i++) {
+        submit_job(args->queue, args->jobs[i]);
+    }
+    return NULL;
+}
+
+void test_submission_queue() {
+    printf("\n=== Testing Submission Queue ===\n");
+
+    int total = SUBMIT_PRODUCERS * SUBMIT_PER_PRODUCER;
+    SubmissionQueue *queue = create_submission_queue(total);
+    Job **jobs = (Job**)malloc(sizeof(Job*) * total);
+    for (int i = 0; i < total; i++) {
+        jobs[i] = create_test_job(i, 0, 1, 0);  // PID / SUBMIT_PER_PRODUCER = producer
+    }
+
+    pthread_t threads[SUBMIT_PRODUCERS];
+    SubmitArgs args[SUBMIT_PRODUCERS];
+    for (int p = 0; p < SUBMIT_PRODUCERS; p++) {
+        args[p].queue = queue;
+        args[p].jobs = &jobs[p * SUBMIT_PER_PRODUCER];
+        pthread_create(&threads[p], NULL, submit_producer, &args[p]);
+    }
+
+    // Consume while the producers are still running
+    int taken = 0;
+    int last_pid[SUBMIT_PRODUCERS] = { -1, -1, -1, -1 };
+    int order_errors = 0;
+    int joined = 0;
+    while (!submissions_finished(queue)) {
+        Job *job = take_submission(queue);
+        if (job != NULL) {
+            int producer = job->PID / SUBMIT_PER_PRODUCER;
+            if (job->PID <= last_pid[producer]) {
+                order_errors++;
+            }
+            last_pid[producer] = job->PID;
+            taken++;
+        } else if (!joined && taken == total) {
+            for (int p = 0; p < SUBMIT_PRODUCERS; p++) {
+                pthread_join(threads[p], NULL);
+            }
+            joined = 1;
+            close_submissions(queue);
+        }
+    }
+    printf("Jobs taken: %d (expected %d)\n", taken, total);
+    printf("Per-producer order kept: %s\n", order_errors == 0 ? "Yes (correct)" : "No (error)");
+    printf("Accepted list complete: %s\n", queue->accepted_count == total ? "Yes (correct)" : "No (error)");
+    printf("Submit after close rejected: %s\n", submit_job(queue, jobs[0]) == -1 ? "Yes (correct)" : "No (error)");
+    destroy_submission_queue(queue);
+
+    SubmissionQueue *small = create_submission_queue(1);
+    printf("Submit past capacity rejected: %s\n",
+           (submit_job(small, jobs[0]) == 0 && submit_job(small, jobs[1]) == -1) ? "Yes (correct)" : "No (error)");
+    destroy_submission_queue(small);  // Frees the untaken node, not the job
+
+    for (int i = 0; i < total; i++) {
+        free(jobs[i]);
+    }
+    free(jobs);
+
+    printf("Submission queue test passed!\n");
+}
+
 void test_edge_cases() {
     printf("\n=== Testing Edge Cases ===\n");
 
@@ -241,7 +922,7 @@ void test_edge_cases() {
 
     // Test with single job
     Job *job = create_test_job(200, 0, 10, 0);
-    enqueue(queue, job, job->service);
+    enqueue(queue, job, job->service, NULL);
     printf("\nAfter enqueuing single job:\n");
     print_queue(queue);
 
@@ -254,6 +935,48 @@ void test_edge_cases() {
     printf("Edge cases test passed!\n");
 }
 
+// Replications of one MLFQ configuration must follow their own seeds
+static int same_summary(const Global_Info *a, const Global_Info *b) {
+    return a->total_simulate_time == b->total_simulate_time &&
+           a->longest_job_completion_time == b->longest_job_completion_time &&
+           a->average_completion == b->average_completion &&
+           a->average_sleep == b->average_sleep;
+}
+
+void test_mlfq_seeds() {
+    printf("\n=== Testing MLFQ Replication Seeds ===\n");
+
+    enum { SEED_JOBS = 40 };
+    Job *jobs[SEED_JOBS];
+    for (int i = 0; i < SEED_JOBS; i++) {
+        jobs[i] = create_test_job(i + 1, i * 3, 50 + (i * 37) % 200, 0);
+    }
+
+    const char *names[] = { "tick", "event", "2 CPUs", "keyed" };
+    for (int variant = 0; variant < 4; variant++) {
+        SchedulerConfig config;
+        init_scheduler_config(&config);
+        config.policy = SCHED_POLICY_MLFQ;
+        if (variant == 1) config.engine = SCHED_ENGINE_EVENT;
+        if (variant == 2) config.cpus = 2;
+        if (variant == 3) config.rng = SIM_RNG_KEYED;
+
+        Global_Info first, again, second;
+        int ok = simulate_summary(jobs, SEED_JOBS, &config, 1, &first) == 0 &&
+                 simulate_summary(jobs, SEED_JOBS, &config, 1, &again) == 0 &&
+                 simulate_summary(jobs, SEED_JOBS, &config, 2, &second) == 0;
+        printf("%s: same seed %s, seeds 1 and 2 %s\n", names[variant],
+               ok && same_summary(&first, &again) ? "repeats (correct)" : "differs (error)",
+               ok && !same_summary(&first, &second) ? "differ (correct)" : "match (error)");
+    }
+
+    for (int i = 0; i < SEED_JOBS; i++) {
+        free(jobs[i]);
+    }
+
+    printf("MLFQ seed test passed!\n");
+}
+
 int main() {
     printf("========================================\n");
     printf("   Queue Implementation Test Suite\n");
@@ -262,9 +985,21 @@ int main() {
     test_fifo_queue();
     test_sjf_queue();
     test_priority_queue();
+    test_heap_queues();
     test_remove_job();
     test_clear_queue();
     test_update_remaining_time();
+    test_node_pool();
+    test_intrusive_nodes();
+    test_handles();
+    test_ring_queue();
+    test_pid_index();
+    test_splice_and_batch();
+    test_queue_stats();
+    test_submission_queue();
+    test_event_calendar();
+    test_arrival_cursor();
+    test_mlfq_seeds();
     test_edge_cases();
 
     printf("\n========================================\n");
@@ -0,0 +1,375 @@
+//
+// Round-Robin Quantum Tuning
+// Implementation File
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/sysinfo.h>
+
+#include "include/tune.h"
+
+static const char *metric_names[] = {"completion", "ready", "sleep", "longest", "total"};
+static const char *metric_labels[] = {
+    "average job completion time", "average time in ready queue",
+    "average time sleeping on I/O", "longest job completion time",
+    "total simulation run time"
+};
+
+int parse_tune_metric(const char *name, TuneMetric *out) {
+    if (name == NULL || out == NULL) return -1;
+    for (int m = TUNE_COMPLETION; m <= TUNE_TOTAL; m++) {
+        if (strcmp(name, metric_names[m]) == 0) {
+            *out = (TuneMetric)m;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static double metric_value(const Global_Info *info, TuneMetric metric) {
+    switch (metric) {
+        case TUNE_COMPLETION: return info->average_completion;
+        case TUNE_READY: return info->average_ready;
+        case TUNE_SLEEP: return info->average_sleep;
+        case TUNE_LONGEST: return info->longest_job_completion_time;
+        case TUNE_TOTAL: return info->total_simulate_time;
+    }
+    return 0.0;
+}
+
+typedef struct {
+    int quantum;
+    double score;       // Metric value, HUGE_VAL if the run failed
+    SimTime ticks;      // Simulated ticks of the run
+} Candidate;
+
+// Orders by score, then by quantum so ties go to the smaller quantum
+static int compare_candidates(const void *a, const void *b) {
+    const Candidate *x = (const Candidate*)a;
+    const Candidate *y = (const Candidate*)b;
+    if (x->score != y->score) return (x->score < y->score) ? -1 : 1;
+    return (x->quantum > y->quantum) - (x->quantum < y->quantum);
+}
+
+typedef struct {
+    Job **jobs;                 // Jobs of this batch (a subset of the input or all of it)
+    int n;
+    SchedulerConfig config;
+    TuneMetric metric;
+    Candidate *batch;
+    int count;
+    atomic_int next;            // Next candidate to hand out
+} TuneBatch;
+
+// Pool worker: scores candidates until the batch is exhausted
+static void *tune_worker(void *arg) {
+    TuneBatch *shared = (TuneBatch*)arg;
+
+    int index;
+    while ((index = atomic_fetch_add(&shared->next, 1)) < shared->count) {
+        Candidate *candidate = &shared->batch[index];
+        SchedulerConfig config = shared->config;
+        config.time_quantum = candidate->quantum;
+        Global_Info info;
+        if (simulate_summary(shared->jobs, shared->n, &config, 1, &info) != 0) {
+            candidate->score = HUGE_VAL;
+            candidate->ticks = 0;
+            continue;
+        }
+        candidate->score = metric_value(&info, shared->metric);
+        candidate->ticks = info.total_simulate_time;
+    }
+    return NULL;
+}
+
+typedef struct {
+    Job **jobs;
+    int n;
+    SchedulerConfig config;
+    TuneMetric metric;
+    int threads;
+    Candidate *full;            // Every quantum already scored on all jobs
+    int full_count;
+    int runs;                   // Simulations so far
+    int full_runs;              // ... of them on all jobs
+    SimTime ticks;              // Simulated ticks so far
+} Tuner;
+
+// Scores count candidates on the n jobs in parallel
+static void evaluate_batch(Tuner *tuner, Job **jobs, int n, Candidate *batch, int count) {
+    TuneBatch shared;
+    shared.jobs = jobs;
+    shared.n = n;
+    shared.config = tuner->config;
+    shared.metric = tuner->metric;
+    shared.batch = batch;
+    shared.count = count;
+    atomic_init(&shared.next, 0);
+
+    int threads = (tuner->threads < count) ? tuner->threads : count;
+    pthread_t *workers = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    int started = 0;
+    while (workers != NULL && started < threads &&
+           pthread_create(&workers[started], NULL, tune_worker, &shared) == 0) {
+        started++;
+    }
+    if (started == 0) {
+        tune_worker(&shared);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    tuner->runs += count;
+    for (int i = 0; i < count; i++) {
+        tuner->ticks += batch[i].ticks;
+    }
+    if (n == tuner->n) {
+        tuner->full_runs += count;
+        for (int i = 0; i < count; i++) {
+            tuner->full[tuner->full_count++] = batch[i];
+        }
+    }
+}
+
+static const Candidate *find_full(const Tuner *tuner, int quantum) {
+    for (int i = 0; i < tuner->full_count; i++) {
+        if (tuner->full[i].quantum == quantum) return &tuner->full[i];
+    }
+    return NULL;
+}
+
+// Scores the quanta not yet run on all jobs, as one parallel batch
+static void score_full(Tuner *tuner, const int *quanta, int count) {
+    Candidate batch[TUNE_CANDIDATES];
+    int pending = 0;
+    for (int i = 0; i < count; i++) {
+        int seen = find_full(tuner, quanta[i]) != NULL;
+        for (int j = 0; j < pending && !seen; j++) {
+            seen = batch[j].quantum == quanta[i];
+        }
+        if (!seen) {
+            batch[pending].quantum = quanta[i];
+            pending++;
+        }
+    }
+    if (pending > 0) {
+        evaluate_batch(tuner, tuner->jobs, tuner->n, batch, pending);
+    }
+}
+
+typedef struct {
+    SimTime arrival;
+    int index;
+} ArrivalKey;
+
+static int compare_arrivals(const void *a, const void *b) {
+    const ArrivalKey *x = (const ArrivalKey*)a;
+    const ArrivalKey *y = (const ArrivalKey*)b;
+    if (x->arrival != y->arrival) return (x->arrival < y->arrival) ? -1 : 1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+// Fills subset with the m earliest-arriving jobs, in input order.
+// order holds the input indices sorted by arrival.
+static void earliest_jobs(Job **jobs, int n, const ArrivalKey *order, int m, Job **subset, char *chosen) {
+    memset(chosen, 0, n);
+    for (int i = 0; i < m; i++) {
+        chosen[order[i].index] = 1;
+    }
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        if (chosen[i]) subset[k++] = jobs[i];
+    }
+}
+
+// Successive halving over quanta spread geometrically over lo..hi.
+// Returns the surviving quantum, or -1 on allocation failure.
+static int successive_halving(Tuner *tuner, int *grid, int count) {
+    int n = tuner->n;
+    ArrivalKey *order = (ArrivalKey*)malloc(sizeof(ArrivalKey) * n);
+    Job **subset = (Job**)malloc(sizeof(Job*) * n);
+    char *chosen = (char*)malloc(n);
+    Candidate *alive = (Candidate*)malloc(sizeof(Candidate) * count);
+    if (order == NULL || subset == NULL || chosen == NULL || alive == NULL) {
+        free(order);
+        free(subset);
+        free(chosen);
+        free(alive);
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        order[i].arrival = tuner->jobs[i]->arrival;
+        order[i].index = i;
+    }
+    qsort(order, n, sizeof(ArrivalKey), compare_arrivals);
+
+    int rounds = 0;
+    while ((1 << rounds) < count) rounds++;
+
+    int alive_count = count;
+    for (int i = 0; i < count; i++) {
+        alive[i].quantum = grid[i];
+    }
+
+    // Round r scores the survivors on n / 2^(rounds-1-r) jobs, so the last
+    // round (two survivors) runs on the whole input
+    for (int r = 0; r < rounds; r++) {
+        int m = n >> (rounds - 1 - r);
+        if (m < TUNE_MIN_JOBS) m = TUNE_MIN_JOBS;
+        if (m > n) m = n;
+
+        if (m < n) {
+            earliest_jobs(tuner->jobs, n, order, m, subset, chosen);
+            evaluate_batch(tuner, subset, m, alive, alive_count);
+        } else {
+            // Whole input: reuse the scores of earlier whole-input rounds
+            int quanta[TUNE_CANDIDATES];
+            for (int i = 0; i < alive_count; i++) {
+                quanta[i] = alive[i].quantum;
+            }
+            score_full(tuner, quanta, alive_count);
+            for (int i = 0; i < alive_count; i++) {
+                alive[i] = *find_full(tuner, alive[i].quantum);
+            }
+        }
+        qsort(alive, alive_count, sizeof(Candidate), compare_candidates);
+        printf("Halving round %d: %d quanta on %d of %d jobs, leader q=%d\n",
+               r + 1, alive_count, m, n, alive[0].quantum);
+        alive_count = (alive_count + 1) / 2;
+    }
+    if (rounds == 0) {
+        score_full(tuner, grid, 1);
+    }
+
+    int best = alive[0].quantum;
+    free(order);
+    free(subset);
+    free(chosen);
+    free(alive);
+    return best;
+}
+
+// Golden-section search over the integers a..b on the whole input
+static void golden_section(Tuner *tuner, int a, int b) {
+    const double phi = (1.0 + sqrt(5.0)) / 2.0;
+
+    while (b - a > 3) {
+        int span = b - a;
+        int c = b - (int)lround(span / phi);
+        int d = a + (int)lround(span / phi);
+        if (c >= d) {
+            c = a + span / 3;
+            d = b - span / 3;
+        }
+        int probes[2] = {c, d};
+        score_full(tuner, probes, 2);
+        if (compare_candidates(find_full(tuner, c), find_full(tuner, d)) <= 0) {
+            b = d;
+        } else {
+            a = c;
+        }
+    }
+
+    int rest[4];
+    int count = 0;
+    for (int q = a; q <= b; q++) {
+        rest[count++] = q;
+    }
+    score_full(tuner, rest, count);
+}
+
+int run_quantum_tuning(Job **jobs, int n, const SchedulerConfig *base, int lo, int hi, TuneMetric metric, int threads) {
+    if (jobs == NULL || n <= 0 || base == NULL) {
+        fprintf(stderr, "Error: no jobs available for the tuning\n");
+        return -1;
+    }
+    if (base->policy != SCHED_POLICY_RR) {
+        fprintf(stderr, "Error: quantum tuning applies to the rr policy only\n");
+        return -1;
+    }
+    if (lo <= 0 || hi < lo || hi > TUNE_MAX_QUANTUM) {
+        fprintf(stderr, "Error: the tuning range must satisfy 1 <= lo <= hi <= %d\n", TUNE_MAX_QUANTUM);
+        return -1;
+    }
+
+    if (threads <= 0) {
+        threads = get_nprocs();
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+
+    Tuner tuner;
+    tuner.jobs = jobs;
+    tuner.n = n;
+    tuner.config = *base;
+    // One host thread per run, no streaming
+    tuner.config.host_threads = 1;
+    tuner.config.submissions = NULL;
+    tuner.metric = metric;
+    tuner.threads = threads;
+    tuner.full_count = 0;
+    tuner.runs = 0;
+    tuner.full_runs = 0;
+    tuner.ticks = 0;
+    // Halving runs each of at most TUNE_CANDIDATES quanta once on all jobs, the
+    // search two per step plus four
+    tuner.full = (Candidate*)malloc(sizeof(Candidate) * (2 * TUNE_CANDIDATES + 128));
+    if (tuner.full == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+
+    // Geometric spread: the metric changes fastest at small quanta
+    int grid[TUNE_CANDIDATES];
+    int count = 0;
+    for (int i = 0; i < TUNE_CANDIDATES; i++) {
+        double t = (double)i / (TUNE_CANDIDATES - 1);
+        int q = (int)lround(lo * pow((double)hi / lo, t));
+        if (count == 0 || q > grid[count - 1]) {
+            grid[count++] = q;
+        }
+    }
+
+    printf("Tuning the RR quantum over %d..%d for the lowest %s\n", lo, hi, metric_labels[metric]);
+    int best = successive_halving(&tuner, grid, count);
+    if (best < 0) {
+        fprintf(stderr, "Out of memory\n");
+        free(tuner.full);
+        return -1;
+    }
+
+    // The optimum lies between the winner's neighbors on the grid
+    int a = lo;
+    int b = hi;
+    for (int i = 0; i < count; i++) {
+        if (grid[i] == best) {
+            a = (i > 0) ? grid[i - 1] : lo;
+            b = (i + 1 < count) ? grid[i + 1] : hi;
+        }
+    }
+    printf("Golden-section search over q=%d..%d on all %d jobs\n", a, b, n);
+    golden_section(&tuner, a, b);
+
+    qsort(tuner.full, tuner.full_count, sizeof(Candidate), compare_candidates);
+    const Candidate *winner = &tuner.full[0];
+    int status = 0;
+    if (winner->score == HUGE_VAL) {
+        fprintf(stderr, "Error: every tuning run failed\n");
+        status = -1;
+    } else {
+        printf("Best quantum: %d (%s %.2f)\n", winner->quantum, metric_labels[metric], winner->score);
+        printf("Simulations: %d (%d on all jobs, %lld ticks); an exhaustive sweep runs %d on all jobs\n",
+               tuner.runs, tuner.full_runs, tuner.ticks, hi - lo + 1);
+    }
+
+    free(tuner.full);
+    return status;
+}
@@ -3,22 +3,286 @@
 //
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <limits.h>
 
 #include "include/utils.h"
 
-void os_srand(unsigned int seed) {
-    srand(seed);
+// SIM_RNG_COMPAT: the same sequence as glibc rand()/srand() (the TYPE_3
+// additive feedback generator), so results match the reference output.
+#define RAND_SEPARATION 3
+
+static int32_t next_random(RandState *rs) {
+    uint32_t value = (uint32_t)rs->state[rs->front] + (uint32_t)rs->state[rs->rear];
+    rs->state[rs->front] = (int32_t)value;
+    rs->front = (rs->front + 1) % RAND_DEGREE;
+    rs->rear = (rs->rear + 1) % RAND_DEGREE;
+    return (int32_t)(value >> 1);
+}
+
+static void seed_compat(RandState *rs, unsigned int seed) {
+    if (seed == 0) {
+        seed = 1;
+    }
+
+    rs->state[0] = (int32_t)seed;
+    int32_t word = (int32_t)seed;
+    for (int i = 1; i < RAND_DEGREE; i++) {
+        // state[i] = (16807 * state[i - 1]) % 2147483647 without overflow
+        int32_t hi = word / 127773;
+        int32_t lo = word % 127773;
+        word = 16807 * lo - 2836 * hi;
+        if (word < 0) {
+            word += 2147483647;
+        }
+        rs->state[i] = word;
+    }
+    rs->front = RAND_SEPARATION;
+    rs->rear = 0;
+
+    for (int i = 0; i < RAND_DEGREE * 10; i++) {
+        next_random(rs);
+    }
+}
+
+// SIM_RNG_XOSHIRO: xoshiro256** seeded through splitmix64
+static uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t next_xoshiro(RandState *rs) {
+    uint64_t *s = rs->xs;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+static void seed_xoshiro(RandState *rs, unsigned int seed) {
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rs->xs[i] = z ^ (z >> 31);
+    }
+    rs->has_spare = 0;
+}
+
+// 32 random bits; each 64-bit output serves two calls
+static uint32_t next_xoshiro32(RandState *rs) {
+    if (rs->has_spare) {
+        rs->has_spare = 0;
+        return rs->spare;
+    }
+    uint64_t word = next_xoshiro(rs);
+    rs->spare = (uint32_t)word;
+    rs->has_spare = 1;
+    return (uint32_t)(word >> 32);
+}
+
+// Bernoulli(1/chance) from 32 bits without modulo bias: exact when chance is
+// a power of two, otherwise within 2^-32 of 1/chance
+static int xoshiro_chance(RandState *rs, int chance) {
+    uint64_t threshold = ((1ULL << 32) + chance - 1) / chance;
+    return next_xoshiro32(rs) < threshold;
+}
+
+// SIM_RNG_KEYED: Philox4x32-10 (Salmon et al., "Parallel random numbers: as
+// easy as 1, 2, 3"). A draw is a pure function of its key and counter, so the
+// outcome for a (PID, tick, kind) does not depend on which draws came before.
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+
+typedef enum {
+    KEYED_IO_REQUEST = 1,
+    KEYED_IO_COMPLETE = 2,
+    KEYED_STREAM = 3        // os_rand() calls, numbered by rs->counter
+} KeyedDrawKind;
+
+static uint32_t philox_word(uint32_t key, int pid, long long tick, KeyedDrawKind kind) {
+    uint32_t c0 = (uint32_t)tick;
+    uint32_t c1 = (uint32_t)((unsigned long long)tick >> 32);
+    uint32_t c2 = (uint32_t)pid;
+    uint32_t c3 = (uint32_t)kind;
+    uint32_t k0 = key;
+    uint32_t k1 = 0x5EEDu;
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    return c0;
+}
+
+// Bernoulli(1/chance) threshold on 32 uniform bits (see xoshiro_chance)
+static uint64_t chance_threshold(int chance) {
+    return ((1ULL << 32) + chance - 1) / chance;
+}
+
+static int keyed_chance(const RandState *rs, int pid, long long tick, KeyedDrawKind kind, int chance) {
+    return philox_word(rs->key, pid, tick, kind) < chance_threshold(chance);
 }
 
-int os_rand(void) {
-    return rand();
+void os_srand(SimContext *sim, unsigned int seed) {
+    if (sim->rng.kind == SIM_RNG_XOSHIRO) {
+        seed_xoshiro(&sim->rng, seed);
+    } else if (sim->rng.kind == SIM_RNG_KEYED) {
+        sim->rng.key = seed;
+        sim->rng.counter = 0;
+    } else {
+        seed_compat(&sim->rng, seed);
+    }
 }
 
-int IO_request(void) {
-    return (os_rand() % CHANCE_OF_IO_REQUEST) == 0;
+// 31 random bits (0..RAND_MAX with glibc) from any generator
+int os_rand(SimContext *sim) {
+    if (sim->rng.kind == SIM_RNG_XOSHIRO) {
+        return (int)(next_xoshiro(&sim->rng) >> 33);
+    }
+    if (sim->rng.kind == SIM_RNG_KEYED) {
+        RandState *rs = &sim->rng;
+        return (int)(philox_word(rs->key, -1, (long long)rs->counter++, KEYED_STREAM) >> 1);
+    }
+    return (int)next_random(&sim->rng);
 }
 
-int IO_complete(void) {
-    return (os_rand() % CHANCE_OF_IO_COMPLETE) == 0;
+static int chance_draw(SimContext *sim, int pid, KeyedDrawKind kind, int chance) {
+    if (sim->rng.kind == SIM_RNG_KEYED) {
+        return keyed_chance(&sim->rng, pid, sim->clock, kind, chance);
+    }
+    if (sim->rng.kind == SIM_RNG_XOSHIRO) {
+        return xoshiro_chance(&sim->rng, chance);
+    }
+    return (os_rand(sim) % chance) == 0;
 }
 
+int IO_request(SimContext *sim, int pid) {
+    return chance_draw(sim, pid, KEYED_IO_REQUEST, CHANCE_OF_IO_REQUEST);
+}
+
+int IO_complete(SimContext *sim, int pid) {
+    return chance_draw(sim, pid, KEYED_IO_COMPLETE, CHANCE_OF_IO_COMPLETE);
+}
+
+int init_draw_batch(DrawBatch *batch, int capacity) {
+    int room = (capacity > 0) ? capacity : 1;
+    batch->pids = (int*)malloc(sizeof(int) * room);
+    batch->outcomes = (unsigned char*)malloc(room);
+    if (batch->pids == NULL || batch->outcomes == NULL) {
+        free_draw_batch(batch);
+        return -1;
+    }
+    return 0;
+}
+
+void free_draw_batch(DrawBatch *batch) {
+    free(batch->pids);
+    free(batch->outcomes);
+    batch->pids = NULL;
+    batch->outcomes = NULL;
+}
+
+// Fills outcomes[0..count) with Bernoulli(1/chance) outcomes. In compat mode
+// this is exactly count single draws in order. xoshiro splits each 64-bit
+// output into log2(chance)-bit fields when chance is a power of two (32
+// outcomes per output for chance 4), otherwise into two 32-bit halves. Keyed
+// draws are independent per pids[i], so the loop has no carried state.
+static void chance_batch(SimContext *sim, KeyedDrawKind kind, int chance, DrawBatch *batch, int count) {
+    RandState *rs = &sim->rng;
+    unsigned char *out = batch->outcomes;
+    if (rs->kind == SIM_RNG_KEYED) {
+        uint64_t threshold = chance_threshold(chance);
+        for (int i = 0; i < count; i++) {
+            out[i] = (unsigned char)(philox_word(rs->key, batch->pids[i], sim->clock, kind) < threshold);
+        }
+        return;
+    }
+    if (rs->kind != SIM_RNG_XOSHIRO) {
+        for (int i = 0; i < count; i++) {
+            out[i] = (unsigned char)((next_random(rs) % chance) == 0);
+        }
+        return;
+    }
+
+    if (chance > 1 && chance <= 65536 && (chance & (chance - 1)) == 0) {
+        int bits = 0;
+        while ((1 << bits) < chance) {
+            bits++;
+        }
+        uint64_t mask = (uint64_t)chance - 1;
+        int per_word = 64 / bits;
+        int i = 0;
+        while (i < count) {
+            uint64_t word = next_xoshiro(rs);
+            for (int k = 0; k < per_word && i < count; k++, i++) {
+                out[i] = (unsigned char)(((word >> (k * bits)) & mask) == 0);
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        out[i] = (unsigned char)xoshiro_chance(rs, chance);
+    }
+}
+
+void IO_complete_batch(SimContext *sim, DrawBatch *batch, int count) {
+    chance_batch(sim, KEYED_IO_COMPLETE, CHANCE_OF_IO_COMPLETE, batch, count);
+}
+
+void IO_request_batch(SimContext *sim, DrawBatch *batch, int count) {
+    chance_batch(sim, KEYED_IO_REQUEST, CHANCE_OF_IO_REQUEST, batch, count);
+}
+
+// Number of Bernoulli(1/chance) trials up to and including the first success,
+// drawn by inversion with a single os_rand() call
+static int geometric_trials(SimContext *sim, int chance) {
+    if (chance <= 1) {
+        return 1;
+    }
+    double u = ((double)os_rand(sim) + 1.0) / ((double)RAND_MAX + 1.0);  // (0, 1]
+    double trials = floor(log(u) / log1p(-1.0 / chance));
+    if (trials >= INT_MAX - 1) {
+        return INT_MAX;
+    }
+    return 1 + (int)trials;
+}
+
+// Keyed: the draws the tick loops would make at first_tick, first_tick + 1, ...
+static int keyed_trials(SimContext *sim, int pid, SimTime first_tick, KeyedDrawKind kind, int chance) {
+    int trials = 1;
+    while (!keyed_chance(&sim->rng, pid, first_tick + trials - 1, kind, chance) && trials < INT_MAX) {
+        trials++;
+    }
+    return trials;
+}
+
+int ticks_until_IO_request(SimContext *sim, int pid, SimTime first_tick) {
+    if (sim->rng.kind == SIM_RNG_KEYED) {
+        return keyed_trials(sim, pid, first_tick, KEYED_IO_REQUEST, CHANCE_OF_IO_REQUEST);
+    }
+    return geometric_trials(sim, CHANCE_OF_IO_REQUEST);
+}
+
+int ticks_until_IO_complete(SimContext *sim, int pid, SimTime first_tick) {
+    if (sim->rng.kind == SIM_RNG_KEYED) {
+        return keyed_trials(sim, pid, first_tick, KEYED_IO_COMPLETE, CHANCE_OF_IO_COMPLETE);
+    }
+    return geometric_trials(sim, CHANCE_OF_IO_COMPLETE);
+}